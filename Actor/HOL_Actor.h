@@ -0,0 +1,360 @@
+/**
+ * @file HOL_Actor.h
+ * @brief Actor runtime: MPSC ring mailboxes scheduled on a fixed worker pool (POSIX threads)
+ *
+ * @section Features
+ * - Each actor owns a bounded DECLARE_MPSC_QUEUE mailbox; any thread may send
+ * - A fixed pool of workers runs only actors that have mail: an actor is put
+ *   on the run queue by the send that finds it idle, never polled
+ * - One scheduling turn processes up to HOL_ACTOR_BATCH messages, then the
+ *   actor goes to the back of the run queue if mail is left (fairness)
+ * - An actor runs on at most one worker at a time: its handler needs no locks
+ * - Thousands of actors cost memory, not threads; throughput follows the
+ *   number of workers (cores)
+ * - hol_actor_system_run() drives the same scheduler on the calling thread
+ *   (deterministic simulations and tests)
+ *
+ * @section Usage_Example
+ * @code
+ * #include "HOL_Actor.h"
+ *
+ * typedef struct { uint8_t op; uint32_t value; } dev_msg_t;
+ * DECLARE_MPSC_QUEUE(dev_msg_t, 16)
+ * DECLARE_ACTOR(device, dev_msg_t, 16)
+ *
+ * static hol_actor_system_t sys;
+ * static device_actor_t devices[5000];
+ *
+ * static void on_message(device_actor_t* self, const dev_msg_t* msg) {
+ *     device_state_t* st = self->state;       // Only this actor touches st
+ *     ...
+ * }
+ *
+ * int main(void) {
+ *     hol_actor_system_init(&sys);
+ *     for (int i = 0; i < 5000; i++) {
+ *         device_actor_init(&devices[i], &sys, on_message, &states[i]);
+ *     }
+ *     hol_actor_system_start(&sys, 4);          // 4 workers for 5000 actors
+ *
+ *     dev_msg_t m = { OP_READ, 0 };
+ *     device_actor_send(&devices[42], &m);      // From any thread or handler
+ *     ...
+ *     hol_actor_system_stop(&sys);              // Drains all mailboxes, joins workers
+ * }
+ * @endcode
+ *
+ * @warning A handler must not block: it holds one of the workers for its turn.
+ */
+
+#ifndef HOL_ACTOR_H
+#define HOL_ACTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "../Queue/HOL_Queue.h"
+
+/* ==================== CONFIGURATION ==================== */
+
+/**
+ * @brief Messages an actor may process in one scheduling turn
+ * @note Larger batches amortise the run-queue hand-off; smaller ones bound how
+ *       long one busy actor delays the others.
+ */
+#ifndef HOL_ACTOR_BATCH
+#define HOL_ACTOR_BATCH 32
+#endif
+
+/**
+ * @brief Worker threads per actor system
+ */
+#ifndef HOL_ACTOR_MAX_WORKERS
+#define HOL_ACTOR_MAX_WORKERS 64
+#endif
+
+/* ==================== RUNTIME ==================== */
+
+typedef struct hol_actor hol_actor_t;
+typedef struct hol_actor_system hol_actor_system_t;
+
+/**
+ * @brief Untyped actor header; first member of every generated NAME_actor_t
+ */
+struct hol_actor {
+    size_t (*run)(hol_actor_t* actor, size_t budget);   /* Handle up to budget messages */
+    bool   (*has_mail)(const hol_actor_t* actor);
+    hol_actor_system_t* system;
+    hol_actor_t* next;                        /* Run queue link */
+    int        scheduled;                     /* 1 while queued or running */
+    uint32_t   rejected;                      /* Sends that found the mailbox full */
+    uint64_t   processed;
+    uint64_t   turns;
+};
+
+/**
+ * @brief One pool thread and its counters
+ */
+typedef struct {
+    hol_actor_system_t* system;
+    pthread_t thread;
+    uint64_t  turns;
+    uint64_t  messages;
+    uint64_t  waits;                          /* Times it found no runnable actor and slept */
+} hol_actor_worker_t;
+
+struct hol_actor_system {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    hol_actor_t*    head;                     /* Run queue: actors with mail, FIFO */
+    hol_actor_t*    tail;
+    size_t          idle_workers;
+    int             stop;
+    bool            running;                  /* Workers started and not yet stopped */
+    size_t          worker_count;             /* Workers of the current / last run */
+    hol_actor_worker_t workers[HOL_ACTOR_MAX_WORKERS];
+};
+
+static inline void hol_actor_system_init(hol_actor_system_t* system)
+{
+    memset(system, 0, sizeof(*system));
+    pthread_mutex_init(&system->lock, NULL);
+    pthread_cond_init(&system->cond, NULL);
+}
+
+/* Append a runnable actor; the caller owns its scheduled flag */
+static inline void hol_actor_enqueue(hol_actor_system_t* system, hol_actor_t* actor)
+{
+    pthread_mutex_lock(&system->lock);
+    actor->next = NULL;
+    if (system->tail) { system->tail->next = actor; }
+    else { system->head = actor; }
+    system->tail = actor;
+    if (system->idle_workers != 0) { pthread_cond_signal(&system->cond); }
+    pthread_mutex_unlock(&system->lock);
+}
+
+static inline hol_actor_t* hol_actor_dequeue_locked(hol_actor_system_t* system)
+{
+    hol_actor_t* actor = system->head;
+    if (actor)
+    {
+        system->head = actor->next;
+        if (!system->head) { system->tail = NULL; }
+    }
+    return actor;
+}
+
+/* Called after a message was stored: schedule the actor unless it already is */
+static inline void hol_actor_notify(hol_actor_t* actor)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);  /* Mailbox store before the flag load */
+    if (__atomic_load_n(&actor->scheduled, __ATOMIC_RELAXED) == 0 &&
+        __atomic_exchange_n(&actor->scheduled, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        hol_actor_enqueue(actor->system, actor);
+    }
+}
+
+/* One scheduling turn of a dequeued actor; returns the messages handled */
+static inline size_t hol_actor_turn(hol_actor_t* actor)
+{
+    size_t handled = actor->run(actor, HOL_ACTOR_BATCH);
+    (void)__atomic_fetch_add(&actor->processed, (uint64_t)handled, __ATOMIC_RELAXED);
+    (void)__atomic_fetch_add(&actor->turns, 1, __ATOMIC_RELAXED);
+
+    if (handled == HOL_ACTOR_BATCH)
+    {
+        hol_actor_enqueue(actor->system, actor);   /* Budget used up: stay scheduled, requeue */
+        return handled;
+    }
+
+    /* Release: this turn's work happens-before the next worker's turn */
+    __atomic_store_n(&actor->scheduled, 0, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);  /* Flag store before the mailbox load */
+    if (actor->has_mail(actor) && __atomic_exchange_n(&actor->scheduled, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        hol_actor_enqueue(actor->system, actor);   /* A send raced with the end of the turn */
+    }
+    return handled;
+}
+
+static void* hol_actor_worker_main(void* arg)
+{
+    hol_actor_worker_t* worker = (hol_actor_worker_t*)arg;
+    hol_actor_system_t* system = worker->system;
+    for (;;)
+    {
+        pthread_mutex_lock(&system->lock);
+        hol_actor_t* actor = hol_actor_dequeue_locked(system);
+        while (!actor && !system->stop)
+        {
+            __atomic_store_n(&worker->waits, worker->waits + 1, __ATOMIC_RELAXED);
+            system->idle_workers++;
+            pthread_cond_wait(&system->cond, &system->lock);
+            system->idle_workers--;
+            actor = hol_actor_dequeue_locked(system);
+        }
+        pthread_mutex_unlock(&system->lock);
+        if (!actor) { break; }                /* Stopping and nothing left to run */
+
+        size_t handled = hol_actor_turn(actor);
+        __atomic_store_n(&worker->turns, worker->turns + 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&worker->messages, worker->messages + handled, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Start worker_count pool threads (1..HOL_ACTOR_MAX_WORKERS); resets the worker counters
+ * @return 0, EINVAL, EBUSY (already running), or the pthread_create() error
+ *         (workers started so far keep running; call hol_actor_system_stop())
+ */
+static inline int hol_actor_system_start(hol_actor_system_t* system, size_t worker_count)
+{
+    if (worker_count == 0 || worker_count > HOL_ACTOR_MAX_WORKERS) { return EINVAL; }
+    if (system->running) { return EBUSY; }
+    memset(system->workers, 0, sizeof(system->workers));
+    system->worker_count = 0;
+    system->running = true;
+    for (size_t i = 0; i < worker_count; i++)
+    {
+        hol_actor_worker_t* worker = &system->workers[system->worker_count];
+        worker->system = system;
+        int err = pthread_create(&worker->thread, NULL, hol_actor_worker_main, worker);
+        if (err != 0) { return err; }
+        system->worker_count++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Let the workers finish every mailbox, then join them
+ * @note Returns once no actor has mail. Actors that keep messaging each other
+ *       forever keep the workers busy; stop sending first.
+ */
+static inline void hol_actor_system_stop(hol_actor_system_t* system)
+{
+    pthread_mutex_lock(&system->lock);
+    system->stop = 1;
+    pthread_cond_broadcast(&system->cond);
+    pthread_mutex_unlock(&system->lock);
+    for (size_t i = 0; i < system->worker_count; i++)
+    {
+        pthread_join(system->workers[i].thread, NULL);
+    }
+    system->running = false;
+    system->stop = 0;
+}
+
+/**
+ * @brief Run scheduling turns on the calling thread (no workers needed)
+ * @param max_turns Upper bound (0 = until no actor has mail)
+ * @return Turns executed
+ */
+static inline size_t hol_actor_system_run(hol_actor_system_t* system, size_t max_turns)
+{
+    size_t turns = 0;
+    while (max_turns == 0 || turns < max_turns)
+    {
+        pthread_mutex_lock(&system->lock);
+        hol_actor_t* actor = hol_actor_dequeue_locked(system);
+        pthread_mutex_unlock(&system->lock);
+        if (!actor) { break; }
+        hol_actor_turn(actor);
+        turns++;
+    }
+    return turns;
+}
+
+/**
+ * @brief Per-worker turns, messages, average batch and sleeps (also after stop)
+ */
+static inline void hol_actor_system_report(const hol_actor_system_t* system, FILE* out)
+{
+    fprintf(out, "%-8s %12s %14s %9s %10s\n", "worker", "turns", "messages", "avg", "waits");
+    for (size_t i = 0; i < system->worker_count; i++)
+    {
+        const hol_actor_worker_t* worker = &system->workers[i];
+        uint64_t turns = __atomic_load_n(&worker->turns, __ATOMIC_RELAXED);
+        uint64_t messages = __atomic_load_n(&worker->messages, __ATOMIC_RELAXED);
+        fprintf(out, "%-8zu %12llu %14llu %9.1f %10llu\n", i, (unsigned long long)turns,
+                (unsigned long long)messages, turns ? (double)messages / (double)turns : 0.0,
+                (unsigned long long)__atomic_load_n(&worker->waits, __ATOMIC_RELAXED));
+    }
+}
+
+/* ==================== TYPED ACTORS ==================== */
+
+/**
+ * @brief Declare an actor type
+ * @param NAME         Actor type name (prefix of the generated identifiers)
+ * @param MSG_TYPE     Message type (copied into the mailbox)
+ * @param MAILBOX_SIZE Mailbox capacity; needs DECLARE_MPSC_QUEUE(MSG_TYPE, MAILBOX_SIZE) first
+ *
+ * Handler: void fn(NAME_actor_t* self, const MSG_TYPE* msg)
+ *
+ * Generates NAME_actor_t (base, handler, state, mailbox) and
+ *   NAME_actor_init(actor, system, handler, state)
+ *   NAME_actor_send(actor, &msg)     false if the mailbox is full (counted in base.rejected)
+ */
+#define DECLARE_ACTOR(NAME, MSG_TYPE, MAILBOX_SIZE)                                                \
+                                                                                                   \
+typedef struct NAME##_actor NAME##_actor_t;                                                        \
+typedef void (*NAME##_actor_fn_t)(NAME##_actor_t* self, const MSG_TYPE* msg);                      \
+                                                                                                   \
+struct NAME##_actor {                                                                              \
+    hol_actor_t base;                                                                              \
+    NAME##_actor_fn_t handler;                                                                     \
+    void* state;                                                                                   \
+    mpsc_queue_##MSG_TYPE##_##MAILBOX_SIZE##_t mailbox;                                            \
+};                                                                                                 \
+                                                                                                   \
+static size_t NAME##_actor_run(hol_actor_t* base, size_t budget)                                   \
+{                                                                                                  \
+    NAME##_actor_t* self = (NAME##_actor_t*)base;                                                  \
+    MSG_TYPE msg;                                                                                  \
+    size_t handled = 0;                                                                            \
+    while (handled < budget && mpsc_queue_pull_##MSG_TYPE##_##MAILBOX_SIZE(&self->mailbox, &msg))  \
+    {                                                                                              \
+        self->handler(self, &msg);                                                                 \
+        handled++;                                                                                 \
+    }                                                                                              \
+    return handled;                                                                                \
+}                                                                                                  \
+                                                                                                   \
+static bool NAME##_actor_has_mail(const hol_actor_t* base)                                         \
+{                                                                                                  \
+    const NAME##_actor_t* self = (const NAME##_actor_t*)base;                                      \
+    return !mpsc_queue_is_empty_##MSG_TYPE##_##MAILBOX_SIZE(&self->mailbox);                       \
+}                                                                                                  \
+                                                                                                   \
+static inline void NAME##_actor_init(NAME##_actor_t* actor, hol_actor_system_t* system,            \
+                                     NAME##_actor_fn_t handler, void* state)                       \
+{                                                                                                  \
+    memset(&actor->base, 0, sizeof(actor->base));                                                  \
+    actor->base.run = NAME##_actor_run;                                                            \
+    actor->base.has_mail = NAME##_actor_has_mail;                                                  \
+    actor->base.system = system;                                                                   \
+    actor->handler = handler;                                                                      \
+    actor->state = state;                                                                          \
+    mpsc_queue_initialize_##MSG_TYPE##_##MAILBOX_SIZE(&actor->mailbox);                            \
+}                                                                                                  \
+                                                                                                   \
+static inline bool NAME##_actor_send(NAME##_actor_t* actor, const MSG_TYPE* msg)                   \
+{                                                                                                  \
+    if (!mpsc_queue_push_##MSG_TYPE##_##MAILBOX_SIZE(&actor->mailbox, *msg))                       \
+    {                                                                                              \
+        __atomic_fetch_add(&actor->base.rejected, 1, __ATOMIC_RELAXED);                            \
+        return false;                                                                              \
+    }                                                                                              \
+    hol_actor_notify(&actor->base);                                                                \
+    return true;                                                                                   \
+}
+
+#endif /* HOL_ACTOR_H */
@@ -0,0 +1,130 @@
+/**
+ * @file bench_logger.c
+ * @brief HOL_Logger micro-benchmarks with optional per-op hardware counters
+ *
+ * Measures the cost of one log call through the shared core into a sink
+ * that discards the line, so only formatting and dispatch are timed:
+ *   filtered   DEBUG call below the level filter (rejected before formatting)
+ *   text_int   text line with two integer arguments
+ *   text_str   text line with a string argument
+ *   json       the same line in JSON-lines mode
+ *   binary     the same line as a binary record (format ID + raw arguments)
+ *
+ * Build:
+ *   cc -O2 -I../Logger -o bench_logger bench_logger.c
+ *
+ * Usage:
+ *   bench_logger [-p] [-n iterations] [-r repeats]
+ *
+ *   -p   Read cycles, instructions, L1D/LLC misses and branch misses per op
+ */
+
+#include "hol_bench.h"
+#include "HOL_Logger.h"
+
+DECLARE_LOG(BENCH, 128, void)
+
+static void bench_null_sink(void* ctx, int level, const char* line, size_t len)
+{
+    (void)ctx;
+    hol_bench_sink += (uint64_t)level + len + (uint8_t)line[0];
+}
+
+static void bench_null_bytes(void* ctx, const uint8_t* data, size_t len)
+{
+    (void)ctx;
+    hol_bench_sink += len + data[0];
+}
+
+static hol_log_binary_t bench_binary;
+
+static void bench_text_mode(void)
+{
+    BENCH_set_binary_stream(NULL);
+    BENCH_set_json_output(false);
+    BENCH_set_level_filter(BENCH_LOG_LEVEL_DEBUG);
+}
+
+static uint64_t bench_filtered(uint64_t iters)
+{
+    BENCH_set_level_filter(BENCH_LOG_LEVEL_INFO);
+    for (uint64_t i = 0; i < iters; i++) { BENCH_LOG_DEBUG("sample %u of %u", (unsigned)i, 7u); }
+    return iters;
+}
+
+static uint64_t bench_text_int(uint64_t iters)
+{
+    for (uint64_t i = 0; i < iters; i++) { BENCH_LOG_INFO("sample %u of %u", (unsigned)i, 7u); }
+    return iters;
+}
+
+static uint64_t bench_text_str(uint64_t iters)
+{
+    static const char* names[4] = { "rx", "tx", "uart2", "spi1" };
+    for (uint64_t i = 0; i < iters; i++) { BENCH_LOG_INFO("link %s up", names[i & 3u]); }
+    return iters;
+}
+
+static uint64_t bench_json(uint64_t iters)
+{
+    BENCH_set_json_output(true);
+    for (uint64_t i = 0; i < iters; i++) { BENCH_LOG_INFO("sample %u of %u", (unsigned)i, 7u); }
+    return iters;
+}
+
+static uint64_t bench_binary_records(uint64_t iters)
+{
+    BENCH_set_binary_stream(&bench_binary);
+    for (uint64_t i = 0; i < iters; i++) { BENCH_LOG_INFO("sample %u of %u", (unsigned)i, 7u); }
+    return iters;
+}
+
+typedef struct {
+    const char* name;
+    uint64_t  (*run)(uint64_t iters);         /* Returns the number of log calls */
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    { "filtered",  bench_filtered },
+    { "text_int",  bench_text_int },
+    { "text_str",  bench_text_str },
+    { "json",      bench_json },
+    { "binary",    bench_binary_records },
+};
+
+int main(int argc, char** argv)
+{
+    bool use_counters = false;
+    uint64_t iterations = 2000000;
+    int repeats = 5;
+    if (!hol_bench_parse_args(argc, argv, &use_counters, &iterations, &repeats)) { return 2; }
+
+    hol_log_binary_init(&bench_binary, bench_null_bytes, NULL);
+    BENCH_set_line_sink(bench_null_sink, NULL);
+    BENCH_log_enable();
+
+    hol_bench_t bench;
+    hol_bench_init(&bench, use_counters);
+    printf("HOL_Logger, %llu calls, best of %d\n", (unsigned long long)iterations, repeats);
+    hol_bench_print_header(&bench);
+
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++)
+    {
+        hol_bench_result_t best = { 0 };
+        uint64_t ops = 0;
+        bench_text_mode();
+        bench_cases[c].run(iterations / 10 + 1);   /* Warm caches and branch predictors */
+        for (int r = 0; r < repeats; r++)
+        {
+            bench_text_mode();
+            hol_bench_start(&bench);
+            ops = bench_cases[c].run(iterations);
+            hol_bench_stop(&bench);
+            hol_bench_keep_best(&bench, &best);
+        }
+        hol_bench_report(&bench, bench_cases[c].name, &best, ops);
+    }
+
+    hol_bench_close(&bench);
+    return 0;
+}
@@ -0,0 +1,419 @@
+/**
+ * @file bench_pipeline.c
+ * @brief End-to-end benchmark: producers -> DECLARE_QUEUE stages -> DECLARE_LOG -> sink
+ *
+ * N producer threads push timestamped messages into the first queue. Each of
+ * the M queues has one consumer thread: the first M-1 forward to the next
+ * queue, the last one formats the message through a DECLARE_LOG TAG into a
+ * null, file or shared-memory sink. Queues are shared between threads, so
+ * each one is guarded by a mutex, as the application must do.
+ *
+ * Reported per stage (queue + its consumer) and end to end:
+ *   throughput  messages per second over the stage's active window
+ *   latency     p50 / p90 / p99 / p99.9 / max, from the push into the
+ *               stage's queue until the consumer handed the message on
+ *               (for the last stage: until the log call returned)
+ *   full waits  pushes that found the stage's queue full (backpressure)
+ *
+ * End-to-end latency starts at the producer's timestamp, so it also covers
+ * the producer's wait for space in the first queue.
+ *
+ * Build:
+ *   cc -O2 -pthread -I../Queue -I../Logger -o bench_pipeline bench_pipeline.c
+ *
+ * Usage:
+ *   bench_pipeline [-P producers] [-S stages] [-n messages] [-R rate] [-a]
+ *                  [-s null|file|shm] [-o path] [-j json_path]
+ *
+ *   -P   Producer threads (default 2)
+ *   -S   Queue stages, 1..PIPE_MAX_STAGES (default 3)
+ *   -n   Messages per producer (default 1000000)
+ *   -R   Messages per second per producer, 0 = as fast as possible (default 0)
+ *   -a   Pin every thread to its own CPU (Linux)
+ *   -s   Log sink: null (default), file (HOL_LogFile.h), shm (mmap'd byte ring)
+ *   -o   Path for the file / shm sink
+ *   -j   Write results as JSON to json_path ("-" = stdout, table goes to stderr)
+ */
+
+#include "hol_bench.h"
+#include "HOL_Queue.h"
+#include "HOL_Logger.h"
+#include "HOL_LogFile.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#ifndef PIPE_MAX_STAGES
+#define PIPE_MAX_STAGES 8
+#endif
+
+#ifndef PIPE_MAX_PRODUCERS
+#define PIPE_MAX_PRODUCERS 64
+#endif
+
+#define PIPE_SHM_SIZE (16u * 1024u * 1024u)   /* Shared-memory ring, header included */
+
+typedef struct {
+    uint64_t created_ns;                      /* Producer timestamp (end-to-end start) */
+    uint64_t enqueued_ns;                     /* Push into the current stage's queue */
+    uint32_t producer;
+    uint32_t seq;
+} pipe_msg;
+
+DECLARE_QUEUE(pipe_msg, 1024)
+DECLARE_LOG(PIPE, 128, void)
+
+/**
+ * @brief One stage: a mutex-guarded queue plus what its consumer measured
+ */
+typedef struct {
+    pthread_mutex_t      lock;
+    queue_pipe_msg_1024_t queue;
+    uint64_t             full_waits;          /* Guarded by lock */
+    uint64_t             first_ns;            /* Consumer: first hand-off */
+    uint64_t             last_ns;             /* Consumer: last hand-off */
+    hol_bench_hist_t     latency;             /* Consumer-owned */
+} pipe_stage_t;
+
+typedef enum { PIPE_SINK_NULL, PIPE_SINK_FILE, PIPE_SINK_SHM } pipe_sink_e;
+
+typedef struct {
+    unsigned    producers;
+    unsigned    stages;
+    uint64_t    messages;                     /* Per producer */
+    uint64_t    rate;                         /* Per producer, 0 = unpaced */
+    bool        pin;
+    pipe_sink_e sink;
+    const char* sink_path;
+    const char* json_path;
+} pipe_config_t;
+
+static pipe_config_t pipe_config = { 2, 3, 1000000, 0, false, PIPE_SINK_NULL, NULL, NULL };
+static pipe_stage_t pipe_stages[PIPE_MAX_STAGES];
+static hol_bench_hist_t pipe_end_to_end;
+static volatile bool pipe_go;
+
+/* ==================== SINKS ==================== */
+
+static void pipe_null_sink(void* ctx, int level, const char* line, size_t len)
+{
+    (void)ctx;
+    hol_bench_sink += (uint64_t)level + len + (uint8_t)line[0];
+}
+
+/**
+ * @brief Shared-memory sink: byte ring in a MAP_SHARED mapping another process can tail
+ *
+ * Header: 64-bit total bytes written; the data area wraps around.
+ */
+typedef struct {
+    volatile uint64_t* written;
+    char*              data;
+    size_t             size;
+} pipe_shm_t;
+
+static void pipe_shm_sink(void* ctx, int level, const char* line, size_t len)
+{
+    pipe_shm_t* shm = (pipe_shm_t*)ctx;
+    (void)level;
+    size_t pos = (size_t)(*shm->written % shm->size);
+    size_t first = (len < shm->size - pos) ? len : shm->size - pos;
+    memcpy(&shm->data[pos], line, first);
+    memcpy(shm->data, line + first, len - first);
+    __atomic_store_n(shm->written, *shm->written + len, __ATOMIC_RELEASE);
+}
+
+/* ==================== STAGE QUEUES ==================== */
+
+static void pipe_push(pipe_stage_t* stage, pipe_msg* msg)
+{
+    pthread_mutex_lock(&stage->lock);
+    while (queue_is_full_pipe_msg_1024(&stage->queue))
+    {
+        stage->full_waits++;
+        pthread_mutex_unlock(&stage->lock);
+        sched_yield();
+        pthread_mutex_lock(&stage->lock);
+    }
+    msg->enqueued_ns = hol_bench_now_ns();
+    queue_push_no_overwrite_pipe_msg_1024(&stage->queue, *msg);
+    pthread_mutex_unlock(&stage->lock);
+}
+
+static void pipe_pull(pipe_stage_t* stage, pipe_msg* msg)
+{
+    for (;;)
+    {
+        pthread_mutex_lock(&stage->lock);
+        bool got = (queue_pull_pipe_msg_1024(&stage->queue, msg) == QUEUE_pipe_msg_1024_OK);
+        pthread_mutex_unlock(&stage->lock);
+        if (got) { return; }
+        sched_yield();
+    }
+}
+
+static void pipe_record(pipe_stage_t* stage, uint64_t enqueued_ns, uint64_t now)
+{
+    if (stage->first_ns == 0) { stage->first_ns = now; }
+    stage->last_ns = now;
+    hol_bench_hist_add(&stage->latency, now - enqueued_ns);
+}
+
+/* ==================== THREADS ==================== */
+
+static void pipe_pin(unsigned cpu)
+{
+#ifdef __linux__
+    if (!pipe_config.pin) { return; }
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % (unsigned)(cpus > 0 ? cpus : 1), &set);
+    (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+static void* pipe_producer(void* arg)
+{
+    unsigned id = (unsigned)(uintptr_t)arg;
+    pipe_pin(pipe_config.stages + id);
+    while (!pipe_go) { sched_yield(); }
+
+    uint64_t interval = (pipe_config.rate != 0) ? 1000000000ull / pipe_config.rate : 0;
+    uint64_t next = hol_bench_now_ns();
+    for (uint64_t i = 0; i < pipe_config.messages; i++)
+    {
+        if (interval != 0)
+        {
+            while (hol_bench_now_ns() < next) { }
+            next += interval;
+        }
+        pipe_msg msg = { hol_bench_now_ns(), 0, id, (uint32_t)i };
+        pipe_push(&pipe_stages[0], &msg);
+    }
+    return NULL;
+}
+
+static void* pipe_forwarder(void* arg)
+{
+    unsigned k = (unsigned)(uintptr_t)arg;
+    pipe_pin(k);
+    uint64_t total = pipe_config.messages * pipe_config.producers;
+    for (uint64_t i = 0; i < total; i++)
+    {
+        pipe_msg msg;
+        pipe_pull(&pipe_stages[k], &msg);
+        uint64_t enqueued = msg.enqueued_ns;
+        pipe_push(&pipe_stages[k + 1], &msg);      /* Stamps the hand-off time */
+        pipe_record(&pipe_stages[k], enqueued, msg.enqueued_ns);
+    }
+    return NULL;
+}
+
+static void* pipe_logger(void* arg)
+{
+    unsigned k = (unsigned)(uintptr_t)arg;
+    pipe_pin(k);
+    uint64_t total = pipe_config.messages * pipe_config.producers;
+    for (uint64_t i = 0; i < total; i++)
+    {
+        pipe_msg msg;
+        pipe_pull(&pipe_stages[k], &msg);
+        PIPE_LOG_INFO("order %u from producer %u accepted",
+                      (unsigned)msg.seq, (unsigned)msg.producer);
+        uint64_t now = hol_bench_now_ns();
+        pipe_record(&pipe_stages[k], msg.enqueued_ns, now);
+        hol_bench_hist_add(&pipe_end_to_end, now - msg.created_ns);
+    }
+    return NULL;
+}
+
+/* ==================== REPORT ==================== */
+
+static double pipe_rate(uint64_t count, uint64_t first_ns, uint64_t last_ns)
+{
+    return (last_ns > first_ns) ? (double)count * 1e9 / (double)(last_ns - first_ns) : 0.0;
+}
+
+static void pipe_print_row(FILE* out, const char* name, double rate, const hol_bench_hist_t* h,
+                           uint64_t full_waits)
+{
+    fprintf(out, "%-12s %12.0f %9llu %9llu %9llu %9llu %10llu %10llu\n", name, rate,
+            (unsigned long long)hol_bench_hist_percentile(h, 50.0),
+            (unsigned long long)hol_bench_hist_percentile(h, 90.0),
+            (unsigned long long)hol_bench_hist_percentile(h, 99.0),
+            (unsigned long long)hol_bench_hist_percentile(h, 99.9),
+            (unsigned long long)h->max_ns, (unsigned long long)full_waits);
+}
+
+static void pipe_json_latency(FILE* out, const hol_bench_hist_t* h)
+{
+    fprintf(out, "{\"p50\": %llu, \"p90\": %llu, \"p99\": %llu, \"p999\": %llu, "
+                 "\"max\": %llu, \"mean\": %.1f}",
+            (unsigned long long)hol_bench_hist_percentile(h, 50.0),
+            (unsigned long long)hol_bench_hist_percentile(h, 90.0),
+            (unsigned long long)hol_bench_hist_percentile(h, 99.0),
+            (unsigned long long)hol_bench_hist_percentile(h, 99.9),
+            (unsigned long long)h->max_ns,
+            h->count ? (double)h->sum_ns / (double)h->count : 0.0);
+}
+
+static void pipe_write_json(FILE* out, uint64_t total, double seconds)
+{
+    static const char* sinks[] = { "null", "file", "shm" };
+    fprintf(out, "{\n  \"benchmark\": \"pipeline\",\n");
+    fprintf(out, "  \"config\": {\"producers\": %u, \"stages\": %u, "
+                 "\"messages_per_producer\": %llu, "
+                 "\"rate_per_producer\": %llu, \"pinned\": %s, \"sink\": \"%s\", "
+                 "\"queue_capacity\": 1024},\n",
+            pipe_config.producers, pipe_config.stages, (unsigned long long)pipe_config.messages,
+            (unsigned long long)pipe_config.rate, pipe_config.pin ? "true" : "false",
+            sinks[pipe_config.sink]);
+    fprintf(out, "  \"seconds\": %.6f,\n", seconds);
+    fprintf(out, "  \"end_to_end\": {\"messages\": %llu, \"throughput_msgs_per_s\": %.0f, "
+                 "\"latency_ns\": ", (unsigned long long)total, (double)total / seconds);
+    pipe_json_latency(out, &pipe_end_to_end);
+    fprintf(out, "},\n  \"stages\": [\n");
+    for (unsigned k = 0; k < pipe_config.stages; k++)
+    {
+        const pipe_stage_t* s = &pipe_stages[k];
+        fprintf(out, "    {\"stage\": %u, \"consumer\": \"%s\", \"throughput_msgs_per_s\": %.0f, "
+                     "\"full_waits\": %llu, \"latency_ns\": ",
+                k, (k + 1 == pipe_config.stages) ? "logger" : "forward",
+                pipe_rate(s->latency.count, s->first_ns, s->last_ns),
+                (unsigned long long)s->full_waits);
+        pipe_json_latency(out, &s->latency);
+        fprintf(out, "}%s\n", (k + 1 == pipe_config.stages) ? "" : ",");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+/* ==================== MAIN ==================== */
+
+static bool pipe_parse_args(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* opt = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(opt, "-a") == 0) { pipe_config.pin = true; continue; }
+        if (val == NULL) { return false; }
+        i++;
+        if      (strcmp(opt, "-P") == 0) { pipe_config.producers = (unsigned)atoi(val); }
+        else if (strcmp(opt, "-S") == 0) { pipe_config.stages = (unsigned)atoi(val); }
+        else if (strcmp(opt, "-n") == 0) { pipe_config.messages = strtoull(val, NULL, 10); }
+        else if (strcmp(opt, "-R") == 0) { pipe_config.rate = strtoull(val, NULL, 10); }
+        else if (strcmp(opt, "-o") == 0) { pipe_config.sink_path = val; }
+        else if (strcmp(opt, "-j") == 0) { pipe_config.json_path = val; }
+        else if (strcmp(opt, "-s") == 0)
+        {
+            if      (strcmp(val, "null") == 0) { pipe_config.sink = PIPE_SINK_NULL; }
+            else if (strcmp(val, "file") == 0) { pipe_config.sink = PIPE_SINK_FILE; }
+            else if (strcmp(val, "shm") == 0)  { pipe_config.sink = PIPE_SINK_SHM; }
+            else { return false; }
+        }
+        else { return false; }
+    }
+    return pipe_config.producers >= 1 && pipe_config.producers <= PIPE_MAX_PRODUCERS &&
+           pipe_config.stages >= 1 && pipe_config.stages <= PIPE_MAX_STAGES &&
+           pipe_config.messages >= 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (!pipe_parse_args(argc, argv))
+    {
+        fprintf(stderr, "usage: %s [-P producers] [-S stages 1..%d] [-n messages] [-R rate] [-a]\n"
+                        "       [-s null|file|shm] [-o path] [-j json_path]\n",
+                argv[0], PIPE_MAX_STAGES);
+        return 2;
+    }
+
+    /* Sink */
+    static hol_log_file_t file_sink;
+    pipe_shm_t shm_sink = { NULL, NULL, 0 };
+    void* shm_map = MAP_FAILED;
+    if (pipe_config.sink == PIPE_SINK_FILE)
+    {
+        const char* path = pipe_config.sink_path ? pipe_config.sink_path : "bench_pipeline.log";
+        if (hol_log_file_open(&file_sink, path, NULL, 0, 0) != 0) { perror(path); return 1; }
+        PIPE_set_line_sink(hol_log_file_line_sink, &file_sink);
+    }
+    else if (pipe_config.sink == PIPE_SINK_SHM)
+    {
+        const char* path = pipe_config.sink_path ? pipe_config.sink_path
+                                                 : "/dev/shm/hol_pipeline.ring";
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || ftruncate(fd, PIPE_SHM_SIZE) != 0) { perror(path); return 1; }
+        shm_map = mmap(NULL, PIPE_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (shm_map == MAP_FAILED) { perror("mmap"); return 1; }
+        shm_sink.written = (volatile uint64_t*)shm_map;
+        shm_sink.data = (char*)shm_map + 64;
+        shm_sink.size = PIPE_SHM_SIZE - 64;
+        PIPE_set_line_sink(pipe_shm_sink, &shm_sink);
+    }
+    else
+    {
+        PIPE_set_line_sink(pipe_null_sink, NULL);
+    }
+    PIPE_log_enable();
+
+    for (unsigned k = 0; k < pipe_config.stages; k++)
+    {
+        pthread_mutex_init(&pipe_stages[k].lock, NULL);
+        queue_initialize_pipe_msg_1024(&pipe_stages[k].queue);
+    }
+
+    /* Consumers first, then producers; all start on pipe_go */
+    pthread_t threads[PIPE_MAX_STAGES + PIPE_MAX_PRODUCERS];
+    unsigned n = 0;
+    for (unsigned k = 0; k < pipe_config.stages; k++)
+    {
+        void* (*fn)(void*) = (k + 1 == pipe_config.stages) ? pipe_logger : pipe_forwarder;
+        pthread_create(&threads[n++], NULL, fn, (void*)(uintptr_t)k);
+    }
+    for (unsigned p = 0; p < pipe_config.producers; p++)
+    {
+        pthread_create(&threads[n++], NULL, pipe_producer, (void*)(uintptr_t)p);
+    }
+
+    uint64_t start = hol_bench_now_ns();
+    pipe_go = true;
+    for (unsigned i = 0; i < n; i++) { pthread_join(threads[i], NULL); }
+    double seconds = (double)(hol_bench_now_ns() - start) / 1e9;
+
+    if (pipe_config.sink == PIPE_SINK_FILE) { hol_log_file_close(&file_sink); }
+    if (shm_map != MAP_FAILED) { munmap(shm_map, PIPE_SHM_SIZE); }
+
+    /* Report */
+    uint64_t total = pipe_config.messages * pipe_config.producers;
+    bool json_stdout = (pipe_config.json_path != NULL && strcmp(pipe_config.json_path, "-") == 0);
+    FILE* table = json_stdout ? stderr : stdout;
+    fprintf(table, "pipeline: %u producers, %u stages, %llu messages, %.3f s\n",
+            pipe_config.producers, pipe_config.stages, (unsigned long long)total, seconds);
+    fprintf(table, "%-12s %12s %9s %9s %9s %9s %10s %10s\n",
+            "stage", "msgs/s", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns", "full waits");
+    for (unsigned k = 0; k < pipe_config.stages; k++)
+    {
+        const pipe_stage_t* s = &pipe_stages[k];
+        char name[16];
+        snprintf(name, sizeof(name), "%u:%s", k,
+                 (k + 1 == pipe_config.stages) ? "logger" : "forward");
+        pipe_print_row(table, name, pipe_rate(s->latency.count, s->first_ns, s->last_ns),
+                       &s->latency, s->full_waits);
+    }
+    pipe_print_row(table, "end-to-end", (double)total / seconds, &pipe_end_to_end, 0);
+
+    if (pipe_config.json_path != NULL)
+    {
+        FILE* out = json_stdout ? stdout : fopen(pipe_config.json_path, "w");
+        if (out == NULL) { perror(pipe_config.json_path); return 1; }
+        pipe_write_json(out, total, seconds);
+        if (out != stdout) { fclose(out); }
+    }
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file bench_queue.c
+ * @brief HOL_Queue micro-benchmarks with optional per-op hardware counters
+ *
+ * Each DECLARE_QUEUE instance is measured on three access patterns:
+ *   push_pull  one element in, one out (queue stays nearly empty)
+ *   burst      fill half the queue, drain it with pull_multiple
+ *   overwrite  push into a full queue (oldest element dropped)
+ *
+ * Sizes come in pairs (1000 / 1024, 4000 / 4096) so the cost of the modulo
+ * wrap versus a power-of-two capacity shows up directly; element widths
+ * from u8 to a 64-byte record show the effect of the buffer footprint.
+ *
+ * Build:
+ *   cc -O2 -I../Queue -o bench_queue bench_queue.c
+ *   cc -O2 -DQUEUE_ENABLE_STATS=1 -I../Queue -o bench_queue_stats bench_queue.c
+ *
+ * Usage:
+ *   bench_queue [-p] [-n iterations] [-r repeats]
+ *
+ *   -p   Read cycles, instructions, L1D/LLC misses and branch misses per op
+ */
+
+#include "hol_bench.h"
+#include "HOL_Queue.h"
+
+typedef struct { uint64_t words[8]; } rec64;   /* One cache line per element */
+
+#define BENCH_QUEUE_CASES(TYPE, SIZE)                                                               \
+static queue_##TYPE##_##SIZE##_t bench_q_##TYPE##_##SIZE;                                           \
+                                                                                                    \
+static void bench_reset_##TYPE##_##SIZE(void)                                                       \
+{                                                                                                   \
+    queue_initialize_##TYPE##_##SIZE(&bench_q_##TYPE##_##SIZE);                                     \
+}                                                                                                   \
+                                                                                                    \
+static uint64_t bench_push_pull_##TYPE##_##SIZE(uint64_t iters)                                     \
+{                                                                                                   \
+    queue_##TYPE##_##SIZE##_t* q = &bench_q_##TYPE##_##SIZE;                                        \
+    TYPE item;                                                                                      \
+    memset(&item, 0, sizeof(item));                                                                 \
+    for (uint64_t i = 0; i < iters; i++)                                                            \
+    {                                                                                               \
+        *(uint8_t*)&item = (uint8_t)i;                                                              \
+        queue_push_##TYPE##_##SIZE(q, item);                                                        \
+        queue_pull_##TYPE##_##SIZE(q, &item);                                                       \
+    }                                                                                               \
+    hol_bench_sink += *(uint8_t*)&item;                                                             \
+    return iters * 2u;                                                                              \
+}                                                                                                   \
+                                                                                                    \
+static uint64_t bench_burst_##TYPE##_##SIZE(uint64_t iters)                                         \
+{                                                                                                   \
+    queue_##TYPE##_##SIZE##_t* q = &bench_q_##TYPE##_##SIZE;                                        \
+    static TYPE out[(SIZE) / 2];                                                                    \
+    TYPE item;                                                                                      \
+    memset(&item, 0, sizeof(item));                                                                 \
+    uint64_t ops = 0;                                                                               \
+    while (ops < iters * 2u)                                                                        \
+    {                                                                                               \
+        for (size_t i = 0; i < (SIZE) / 2; i++)                                                     \
+        {                                                                                           \
+            *(uint8_t*)&item = (uint8_t)i;                                                          \
+            queue_push_no_overwrite_##TYPE##_##SIZE(q, item);                                       \
+        }                                                                                           \
+        size_t got = 0;                                                                             \
+        queue_pull_multiple_##TYPE##_##SIZE(q, out, (SIZE) / 2, &got);                              \
+        ops += (SIZE) / 2 + got;                                                                    \
+    }                                                                                               \
+    hol_bench_sink += *(uint8_t*)&out[0];                                                           \
+    return ops;                                                                                     \
+}                                                                                                   \
+                                                                                                    \
+static uint64_t bench_overwrite_##TYPE##_##SIZE(uint64_t iters)                                     \
+{                                                                                                   \
+    queue_##TYPE##_##SIZE##_t* q = &bench_q_##TYPE##_##SIZE;                                        \
+    TYPE item;                                                                                      \
+    memset(&item, 0, sizeof(item));                                                                 \
+    while (!queue_is_full_##TYPE##_##SIZE(q)) { queue_push_##TYPE##_##SIZE(q, item); }              \
+    for (uint64_t i = 0; i < iters; i++)                                                            \
+    {                                                                                               \
+        *(uint8_t*)&item = (uint8_t)i;                                                              \
+        queue_push_##TYPE##_##SIZE(q, item);                                                        \
+    }                                                                                               \
+    hol_bench_sink += queue_count_##TYPE##_##SIZE(q);                                               \
+    return iters;                                                                                   \
+}
+
+DECLARE_QUEUE(u8, 64)
+DECLARE_QUEUE(u32, 1000)
+DECLARE_QUEUE(u32, 1024)
+DECLARE_QUEUE(u64, 4000)
+DECLARE_QUEUE(u64, 4096)
+DECLARE_QUEUE(rec64, 256)
+
+BENCH_QUEUE_CASES(u8, 64)
+BENCH_QUEUE_CASES(u32, 1000)
+BENCH_QUEUE_CASES(u32, 1024)
+BENCH_QUEUE_CASES(u64, 4000)
+BENCH_QUEUE_CASES(u64, 4096)
+BENCH_QUEUE_CASES(rec64, 256)
+
+typedef struct {
+    const char* name;
+    uint64_t  (*run)(uint64_t iters);         /* Returns the number of queue operations */
+    void      (*reset)(void);
+} bench_case_t;
+
+#define BENCH_QUEUE_ENTRIES(TYPE, SIZE)                                                             \
+    { "push_pull " #TYPE "/" #SIZE, bench_push_pull_##TYPE##_##SIZE, bench_reset_##TYPE##_##SIZE }, \
+    { "burst     " #TYPE "/" #SIZE, bench_burst_##TYPE##_##SIZE,     bench_reset_##TYPE##_##SIZE }, \
+    { "overwrite " #TYPE "/" #SIZE, bench_overwrite_##TYPE##_##SIZE, bench_reset_##TYPE##_##SIZE }
+
+static const bench_case_t bench_cases[] = {
+    BENCH_QUEUE_ENTRIES(u8, 64),
+    BENCH_QUEUE_ENTRIES(u32, 1000),
+    BENCH_QUEUE_ENTRIES(u32, 1024),
+    BENCH_QUEUE_ENTRIES(u64, 4000),
+    BENCH_QUEUE_ENTRIES(u64, 4096),
+    BENCH_QUEUE_ENTRIES(rec64, 256),
+};
+
+int main(int argc, char** argv)
+{
+    bool use_counters = false;
+    uint64_t iterations = 10000000;
+    int repeats = 5;
+    if (!hol_bench_parse_args(argc, argv, &use_counters, &iterations, &repeats)) { return 2; }
+
+    hol_bench_t bench;
+    hol_bench_init(&bench, use_counters);
+    printf("HOL_Queue, %llu iterations, best of %d%s\n", (unsigned long long)iterations, repeats,
+           QUEUE_ENABLE_STATS ? ", QUEUE_ENABLE_STATS=1" : "");
+    hol_bench_print_header(&bench);
+
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++)
+    {
+        hol_bench_result_t best = { 0 };
+        uint64_t ops = 0;
+        bench_cases[c].reset();
+        bench_cases[c].run(iterations / 10 + 1);   /* Warm caches and branch predictors */
+        for (int r = 0; r < repeats; r++)
+        {
+            bench_cases[c].reset();
+            hol_bench_start(&bench);
+            ops = bench_cases[c].run(iterations);
+            hol_bench_stop(&bench);
+            hol_bench_keep_best(&bench, &best);
+        }
+        hol_bench_report(&bench, bench_cases[c].name, &best, ops);
+    }
+
+    hol_bench_close(&bench);
+    return 0;
+}
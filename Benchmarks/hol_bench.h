@@ -0,0 +1,388 @@
+/**
+ * @file hol_bench.h
+ * @brief Minimal host benchmark harness: wall time plus optional hardware counters
+ *
+ * @section Features
+ * - Monotonic wall time per measured region, reported as ns/op
+ * - Optional perf_event_open counters (Linux): cycles, instructions,
+ *   L1D read misses, LLC read misses, branch misses - reported per op
+ * - Counters are opened as one group, so they cover the same instructions;
+ *   a counter the CPU or VM lacks prints "-" instead of failing the run
+ * - Multiplexed counters are scaled by time_enabled / time_running
+ * - Best-of-N repeats: the fastest run and its counters are reported
+ * - Log-linear latency histogram with percentiles for multi-threaded runs
+ *
+ * @section Usage_Example
+ * @code
+ * hol_bench_t bench;
+ * hol_bench_init(&bench, use_counters);
+ * hol_bench_print_header(&bench);
+ *
+ * hol_bench_result_t best = { 0 };
+ * for (int r = 0; r < repeats; r++) {
+ *     hol_bench_start(&bench);
+ *     for (uint64_t i = 0; i < iters; i++) { work(); }
+ *     hol_bench_stop(&bench);
+ *     hol_bench_keep_best(&bench, &best);
+ * }
+ * hol_bench_report(&bench, "work", &best, iters);
+ * hol_bench_close(&bench);
+ * @endcode
+ *
+ * @note Counters need kernel.perf_event_paranoid <= 2 (user-space events)
+ *       or CAP_PERFMON. Most containers and some VMs expose none.
+ * @note Include before any system header (needs syscall() from _GNU_SOURCE).
+ */
+
+#ifndef HOL_BENCH_H
+#define HOL_BENCH_H
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Build perf_event_open support (Linux only)
+ */
+#ifndef HOL_BENCH_PERF
+#ifdef __linux__
+#define HOL_BENCH_PERF 1
+#else
+#define HOL_BENCH_PERF 0
+#endif
+#endif
+
+#if HOL_BENCH_PERF
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+/**
+ * @brief Hardware counters read around each measured region
+ */
+typedef enum {
+    HOL_BENCH_CYCLES = 0,
+    HOL_BENCH_INSTRUCTIONS,
+    HOL_BENCH_L1D_MISSES,
+    HOL_BENCH_LLC_MISSES,
+    HOL_BENCH_BRANCH_MISSES,
+    HOL_BENCH_COUNTERS
+} hol_bench_counter_e;
+
+/**
+ * @brief One measured run
+ */
+typedef struct {
+    uint64_t elapsed_ns;                      /* 0 = no run kept yet */
+    uint64_t counts[HOL_BENCH_COUNTERS];      /* Scaled counter deltas */
+} hol_bench_result_t;
+
+/**
+ * @brief Harness state (counter file descriptors, current run)
+ */
+typedef struct {
+    int      fds[HOL_BENCH_COUNTERS];         /* -1 = counter not available */
+    int      leader;                          /* Group leader fd, -1 = no counters */
+    uint64_t start_ns;
+    hol_bench_result_t last;                  /* Result of the last start/stop pair */
+} hol_bench_t;
+
+/**
+ * @brief Sink for benchmark results the compiler must not optimise away
+ */
+static volatile uint64_t hol_bench_sink;
+
+static inline uint64_t hol_bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#if HOL_BENCH_PERF
+static inline int hol_bench_open_counter(uint32_t type, uint64_t config, int group)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group < 0) ? 1 : 0;      /* Members follow the leader */
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+#define HOL_BENCH_CACHE_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+#endif
+
+/**
+ * @brief Initialise the harness
+ * @param bench        Harness state
+ * @param use_counters Open hardware counters (ignored without HOL_BENCH_PERF)
+ * @note If counters were requested but none could be opened, the reason is
+ *       printed to stderr and the run continues with wall time only.
+ */
+static inline void hol_bench_init(hol_bench_t* bench, bool use_counters)
+{
+    memset(bench, 0, sizeof(*bench));
+    bench->leader = -1;
+    for (int i = 0; i < HOL_BENCH_COUNTERS; i++) { bench->fds[i] = -1; }
+
+#if HOL_BENCH_PERF
+    if (!use_counters) { return; }
+
+    static const struct { uint32_t type; uint64_t config; } events[HOL_BENCH_COUNTERS] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, HOL_BENCH_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D) },
+        { PERF_TYPE_HW_CACHE, HOL_BENCH_CACHE_MISS(PERF_COUNT_HW_CACHE_LL) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    bench->leader = hol_bench_open_counter(events[0].type, events[0].config, -1);
+    if (bench->leader < 0)
+    {
+        fprintf(stderr, "hardware counters unavailable (%s), reporting time only\n",
+                strerror(errno));
+        return;
+    }
+    bench->fds[0] = bench->leader;
+    for (int i = 1; i < HOL_BENCH_COUNTERS; i++)
+    {
+        bench->fds[i] = hol_bench_open_counter(events[i].type, events[i].config, bench->leader);
+    }
+#else
+    if (use_counters) { fprintf(stderr, "hardware counters not built, reporting time only\n"); }
+#endif
+}
+
+/**
+ * @brief Release the counters
+ */
+static inline void hol_bench_close(hol_bench_t* bench)
+{
+    for (int i = 0; i < HOL_BENCH_COUNTERS; i++)
+    {
+        if (bench->fds[i] >= 0) { close(bench->fds[i]); }
+        bench->fds[i] = -1;
+    }
+    bench->leader = -1;
+}
+
+/**
+ * @brief Begin a measured region (counters reset and enabled as a group)
+ */
+static inline void hol_bench_start(hol_bench_t* bench)
+{
+#if HOL_BENCH_PERF
+    if (bench->leader >= 0)
+    {
+        ioctl(bench->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(bench->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    bench->start_ns = hol_bench_now_ns();
+}
+
+/**
+ * @brief End a measured region; the result is in bench->last
+ */
+static inline void hol_bench_stop(hol_bench_t* bench)
+{
+    uint64_t now = hol_bench_now_ns();
+#if HOL_BENCH_PERF
+    if (bench->leader >= 0)
+    {
+        ioctl(bench->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    bench->last.elapsed_ns = now - bench->start_ns;
+
+    for (int i = 0; i < HOL_BENCH_COUNTERS; i++)
+    {
+        bench->last.counts[i] = 0;
+#if HOL_BENCH_PERF
+        uint64_t value[3];   /* value, time_enabled, time_running */
+        if (bench->fds[i] >= 0 && read(bench->fds[i], value, sizeof(value)) == sizeof(value))
+        {
+            /* Scale if the kernel multiplexed the group with other events */
+            if (value[2] != 0 && value[2] < value[1])
+            {
+                value[0] = (uint64_t)((double)value[0] * (double)value[1] / (double)value[2]);
+            }
+            bench->last.counts[i] = value[0];
+        }
+#endif
+    }
+}
+
+/**
+ * @brief Keep the last run in best if it was the fastest so far
+ */
+static inline void hol_bench_keep_best(const hol_bench_t* bench, hol_bench_result_t* best)
+{
+    if (best->elapsed_ns == 0 || bench->last.elapsed_ns < best->elapsed_ns) { *best = bench->last; }
+}
+
+/**
+ * @brief Print the column header matching hol_bench_report()
+ */
+static inline void hol_bench_print_header(const hol_bench_t* bench)
+{
+    printf("%-32s %10s", "benchmark", "ns/op");
+    if (bench->leader >= 0)
+    {
+        printf(" %10s %10s %6s %10s %10s %10s",
+               "cycles/op", "insn/op", "IPC", "L1D-mis/op", "LLC-mis/op", "br-mis/op");
+    }
+    printf("\n");
+}
+
+static inline void hol_bench_print_per_op(const hol_bench_t* bench, const hol_bench_result_t* r,
+                                          int counter, uint64_t ops)
+{
+    if (bench->fds[counter] < 0) { printf(" %10s", "-"); }
+    else                         { printf(" %10.3f", (double)r->counts[counter] / (double)ops); }
+}
+
+/**
+ * @brief Print one result line, every value divided by ops
+ */
+static inline void hol_bench_report(const hol_bench_t* bench, const char* name,
+                                    const hol_bench_result_t* r, uint64_t ops)
+{
+    if (ops == 0) { ops = 1; }
+    printf("%-32s %10.2f", name, (double)r->elapsed_ns / (double)ops);
+    if (bench->leader >= 0)
+    {
+        hol_bench_print_per_op(bench, r, HOL_BENCH_CYCLES, ops);
+        hol_bench_print_per_op(bench, r, HOL_BENCH_INSTRUCTIONS, ops);
+        if (bench->fds[HOL_BENCH_INSTRUCTIONS] >= 0 && r->counts[HOL_BENCH_CYCLES] != 0)
+        {
+            printf(" %6.2f", (double)r->counts[HOL_BENCH_INSTRUCTIONS] /
+                             (double)r->counts[HOL_BENCH_CYCLES]);
+        }
+        else { printf(" %6s", "-"); }
+        hol_bench_print_per_op(bench, r, HOL_BENCH_L1D_MISSES, ops);
+        hol_bench_print_per_op(bench, r, HOL_BENCH_LLC_MISSES, ops);
+        hol_bench_print_per_op(bench, r, HOL_BENCH_BRANCH_MISSES, ops);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+/* ==================== LATENCY HISTOGRAM ==================== */
+
+/**
+ * @brief Sub-buckets per power of two (4 bits: 16 buckets, <= 6.25% error)
+ */
+#define HOL_BENCH_HIST_SUB_BITS 4
+#define HOL_BENCH_HIST_SUB      (1u << HOL_BENCH_HIST_SUB_BITS)
+#define HOL_BENCH_HIST_BUCKETS  (64u * HOL_BENCH_HIST_SUB)
+
+/**
+ * @brief Log-linear latency histogram (ns); one writer, merge to combine
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t buckets[HOL_BENCH_HIST_BUCKETS];
+} hol_bench_hist_t;
+
+static inline unsigned hol_bench_hist_index(uint64_t ns)
+{
+    if (ns < HOL_BENCH_HIST_SUB) { return (unsigned)ns; }
+    unsigned exp = 63u - (unsigned)__builtin_clzll(ns);
+    unsigned sub = (unsigned)(ns >> (exp - HOL_BENCH_HIST_SUB_BITS)) & (HOL_BENCH_HIST_SUB - 1u);
+    return (exp - HOL_BENCH_HIST_SUB_BITS + 1u) * HOL_BENCH_HIST_SUB + sub;
+}
+
+/* Largest value that falls into bucket index */
+static inline uint64_t hol_bench_hist_upper(unsigned index)
+{
+    if (index < HOL_BENCH_HIST_SUB) { return index; }
+    unsigned exp = index / HOL_BENCH_HIST_SUB + HOL_BENCH_HIST_SUB_BITS - 1u;
+    uint64_t sub = index % HOL_BENCH_HIST_SUB;
+    return ((HOL_BENCH_HIST_SUB + sub + 1u) << (exp - HOL_BENCH_HIST_SUB_BITS)) - 1u;
+}
+
+static inline void hol_bench_hist_add(hol_bench_hist_t* hist, uint64_t ns)
+{
+    hist->buckets[hol_bench_hist_index(ns)]++;
+    hist->count++;
+    hist->sum_ns += ns;
+    if (ns > hist->max_ns) { hist->max_ns = ns; }
+}
+
+static inline void hol_bench_hist_merge(hol_bench_hist_t* dst, const hol_bench_hist_t* src)
+{
+    for (unsigned i = 0; i < HOL_BENCH_HIST_BUCKETS; i++) { dst->buckets[i] += src->buckets[i]; }
+    dst->count += src->count;
+    dst->sum_ns += src->sum_ns;
+    if (src->max_ns > dst->max_ns) { dst->max_ns = src->max_ns; }
+}
+
+/**
+ * @brief Latency at percentile (0..100], reported as the bucket's upper bound
+ */
+static inline uint64_t hol_bench_hist_percentile(const hol_bench_hist_t* hist, double percentile)
+{
+    if (hist->count == 0) { return 0; }
+    uint64_t rank = (uint64_t)((double)hist->count * percentile / 100.0 + 0.5);
+    if (rank < 1) { rank = 1; }
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < HOL_BENCH_HIST_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= rank)
+        {
+            uint64_t upper = hol_bench_hist_upper(i);
+            return (upper < hist->max_ns) ? upper : hist->max_ns;
+        }
+    }
+    return hist->max_ns;
+}
+
+/**
+ * @brief Parse the common options: [-p] [-n iterations] [-r repeats]
+ * @return false on an unknown option (usage printed)
+ */
+static inline bool hol_bench_parse_args(int argc, char** argv, bool* use_counters,
+                                        uint64_t* iterations, int* repeats)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-p") == 0) { *use_counters = true; }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            *iterations = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) { *repeats = atoi(argv[++i]); }
+        else
+        {
+            fprintf(stderr, "usage: %s [-p] [-n iterations] [-r repeats]\n"
+                            "  -p  read hardware counters (perf_event_open)\n", argv[0]);
+            return false;
+        }
+    }
+    if (*iterations == 0) { *iterations = 1; }
+    if (*repeats < 1) { *repeats = 1; }
+    return true;
+}
+
+#endif /* HOL_BENCH_H */
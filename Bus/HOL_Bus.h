@@ -0,0 +1,346 @@
+/**
+ * @file HOL_Bus.h
+ * @brief Topic-based publish / subscribe bus over HOL_Queue ring buffers
+ *
+ * @section Features
+ * - Topics are named once at init and used as small integer IDs afterwards
+ * - Each subscriber owns a bounded DECLARE_QUEUE ring with its own overflow
+ *   policy: drop the oldest, drop the newest, or reject the publish
+ * - Publish = one array lookup plus one push per subscriber
+ * - Optional shared broadcast ring per topic: one write per publish, any
+ *   number of readers with private cursors (for topics with many listeners)
+ * - Per-topic and per-subscriber counters (published, rejected, delivered, dropped)
+ * - Zero dynamic memory: the bus, rings and readers are caller-owned objects
+ *
+ * @section Usage_Example
+ * @code
+ * #include "HOL_Bus.h"
+ *
+ * typedef struct { uint16_t id; int32_t value; } event_t;
+ * DECLARE_QUEUE(event_t, 16)                 // Ring type (once per type / depth)
+ * DECLARE_BUS(app, event_t, 16)              // Bus "app", 16-message rings
+ *
+ * static app_bus_t bus;
+ * static app_bus_sub_t display, logger;
+ * static hol_bus_topic_t TEMP;
+ *
+ * void init(void) {
+ *     app_bus_init(&bus);
+ *     TEMP = app_bus_topic(&bus, "sensor/temp");                   // Name -> ID, once
+ *     app_bus_subscribe(&bus, TEMP, &display, HOL_BUS_DROP_OLDEST); // Latest values matter
+ *     app_bus_subscribe(&bus, TEMP, &logger, HOL_BUS_DROP_NEWEST);  // Keep the history
+ * }
+ *
+ * void sensor_task(void) {
+ *     event_t e = { 1, read_temperature() };
+ *     app_bus_publish(&bus, TEMP, &e);
+ * }
+ *
+ * void display_task(void) {
+ *     event_t e;
+ *     while (app_bus_receive(&display, &e)) { show(e.value); }
+ * }
+ * @endcode
+ *
+ * @warning Same rules as HOL_Queue: not thread or ISR safe unless HOL_BUS_LOCK /
+ *          HOL_BUS_UNLOCK are defined. Topics and subscriptions are set up at
+ *          init; publish and receive are the runtime path.
+ */
+
+#ifndef HOL_BUS_H
+#define HOL_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "../Queue/HOL_Queue.h"
+
+/* ==================== CONFIGURATION ==================== */
+
+/**
+ * @brief Topics per bus
+ */
+#ifndef HOL_BUS_MAX_TOPICS
+#define HOL_BUS_MAX_TOPICS 16
+#endif
+
+/**
+ * @brief Ring subscribers per topic (broadcast readers are not limited)
+ */
+#ifndef HOL_BUS_MAX_SUBSCRIBERS
+#define HOL_BUS_MAX_SUBSCRIBERS 8
+#endif
+
+/**
+ * @brief Critical section around publish / receive
+ * @note Default: none (single context). For threads use a mutex, for ISR
+ *       publishers disable interrupts, e.g.
+ *       #define HOL_BUS_LOCK()   uint32_t _primask = __get_PRIMASK(); __disable_irq()
+ *       #define HOL_BUS_UNLOCK() __set_PRIMASK(_primask)
+ */
+#ifndef HOL_BUS_LOCK
+#define HOL_BUS_LOCK()
+#define HOL_BUS_UNLOCK()
+#endif
+
+/* ==================== SHARED TYPES ==================== */
+
+/**
+ * @brief Topic ID returned by NAME_bus_topic(); index into the bus topic table
+ */
+typedef int16_t hol_bus_topic_t;
+
+#define HOL_BUS_INVALID_TOPIC ((hol_bus_topic_t)-1)
+
+/**
+ * @brief What a subscriber ring does when a message arrives while it is full
+ */
+typedef enum {
+    HOL_BUS_DROP_OLDEST = 0,                  /* Overwrite the oldest message (latest state wins) */
+    HOL_BUS_DROP_NEWEST,                      /* Keep the ring, discard the new message */
+    HOL_BUS_REJECT                            /* Fail the whole publish; nobody receives it */
+} hol_bus_policy_t;
+
+typedef enum {
+    HOL_BUS_OK = 0,
+    HOL_BUS_ERROR_NULL_POINTER,
+    HOL_BUS_ERROR_TOPIC,                      /* Unknown topic ID / no broadcast ring */
+    HOL_BUS_ERROR_FULL,                       /* Table full, or a REJECT subscriber is full */
+    HOL_BUS_ERROR_STATE                       /* Already subscribed / not subscribed */
+} hol_bus_status_t;
+
+/* ==================== BUS DECLARATION ==================== */
+
+/**
+ * @brief Bus declaration macro
+ * @param NAME     Bus name (prefix of the generated identifiers)
+ * @param MSG_TYPE Message type (copied by value into the rings)
+ * @param DEPTH    Messages per subscriber ring and per broadcast ring (power of two
+ *                 recommended: the broadcast sequence wraps at 2^32)
+ *
+ * Generates NAME_bus_t, NAME_bus_sub_t (ring subscriber), NAME_bus_broadcast_t /
+ * NAME_bus_reader_t (shared ring and its cursors) and the NAME_bus_* functions.
+ * Needs DECLARE_QUEUE(MSG_TYPE, DEPTH) first (once per type and depth), so several
+ * buses and plain queues can share one ring type.
+ */
+#define DECLARE_BUS(NAME, MSG_TYPE, DEPTH)                                                         \
+                                                                                                   \
+typedef struct {                                                                                   \
+    queue_##MSG_TYPE##_##DEPTH##_t ring;                                                           \
+    hol_bus_policy_t policy;                                                                       \
+    hol_bus_topic_t topic;                    /* HOL_BUS_INVALID_TOPIC when not subscribed */      \
+    uint32_t delivered;                       /* Messages stored in the ring */                    \
+    uint32_t dropped;                         /* Messages lost to the overflow policy */           \
+} NAME##_bus_sub_t;                                                                                \
+                                                                                                   \
+typedef struct {                                                                                   \
+    MSG_TYPE slots[DEPTH];                                                                         \
+    uint32_t write_seq;                       /* Messages ever written */                          \
+} NAME##_bus_broadcast_t;                                                                          \
+                                                                                                   \
+typedef struct {                                                                                   \
+    const NAME##_bus_broadcast_t* ring;                                                            \
+    uint32_t read_seq;                                                                             \
+    uint32_t received;                                                                             \
+    uint32_t lost;                            /* Overwritten before this reader got to them */     \
+} NAME##_bus_reader_t;                                                                             \
+                                                                                                   \
+typedef struct {                                                                                   \
+    const char* name;                                                                              \
+    NAME##_bus_sub_t* subs[HOL_BUS_MAX_SUBSCRIBERS];                                               \
+    uint8_t sub_count;                                                                             \
+    uint8_t reject_count;                     /* Subscribers with HOL_BUS_REJECT */                \
+    NAME##_bus_broadcast_t* broadcast;                                                             \
+    uint32_t published;                                                                            \
+    uint32_t rejected;                                                                             \
+} NAME##_bus_topic_t;                                                                              \
+                                                                                                   \
+typedef struct {                                                                                   \
+    NAME##_bus_topic_t topics[HOL_BUS_MAX_TOPICS];                                                 \
+    uint8_t topic_count;                                                                           \
+} NAME##_bus_t;                                                                                    \
+                                                                                                   \
+static inline void NAME##_bus_init(NAME##_bus_t* bus)                                              \
+{                                                                                                  \
+    memset(bus, 0, sizeof(*bus));                                                                  \
+}                                                                                                  \
+                                                                                                   \
+/* Find a topic by name; HOL_BUS_INVALID_TOPIC if it was never created */                          \
+static inline hol_bus_topic_t NAME##_bus_find_topic(const NAME##_bus_t* bus, const char* name)     \
+{                                                                                                  \
+    for (uint8_t i = 0; i < bus->topic_count; i++)                                                 \
+    {                                                                                              \
+        if (strcmp(bus->topics[i].name, name) == 0) { return (hol_bus_topic_t)i; }                 \
+    }                                                                                              \
+    return HOL_BUS_INVALID_TOPIC;                                                                  \
+}                                                                                                  \
+                                                                                                   \
+/* Find or create a topic; the name must stay valid (string literal) */                            \
+static inline hol_bus_topic_t NAME##_bus_topic(NAME##_bus_t* bus, const char* name)                \
+{                                                                                                  \
+    hol_bus_topic_t id = NAME##_bus_find_topic(bus, name);                                         \
+    if (id != HOL_BUS_INVALID_TOPIC) { return id; }                                                \
+    if (bus->topic_count >= HOL_BUS_MAX_TOPICS) { return HOL_BUS_INVALID_TOPIC; }                  \
+    bus->topics[bus->topic_count].name = name;                                                     \
+    return (hol_bus_topic_t)bus->topic_count++;                                                    \
+}                                                                                                  \
+                                                                                                   \
+static inline const char* NAME##_bus_topic_name(const NAME##_bus_t* bus, hol_bus_topic_t topic)    \
+{                                                                                                  \
+    return (topic >= 0 && topic < bus->topic_count) ? bus->topics[topic].name : NULL;              \
+}                                                                                                  \
+                                                                                                   \
+/* Attach a ring subscriber to a topic (one topic per subscriber object) */                        \
+static inline hol_bus_status_t NAME##_bus_subscribe(NAME##_bus_t* bus, hol_bus_topic_t topic,      \
+                                                    NAME##_bus_sub_t* sub, hol_bus_policy_t policy) \
+{                                                                                                  \
+    if (!bus || !sub) { return HOL_BUS_ERROR_NULL_POINTER; }                                       \
+    if (topic < 0 || topic >= bus->topic_count) { return HOL_BUS_ERROR_TOPIC; }                    \
+    NAME##_bus_topic_t* t = &bus->topics[topic];                                                   \
+    if (t->sub_count >= HOL_BUS_MAX_SUBSCRIBERS) { return HOL_BUS_ERROR_FULL; }                    \
+    for (uint8_t i = 0; i < t->sub_count; i++)                                                     \
+    {                                                                                              \
+        if (t->subs[i] == sub) { return HOL_BUS_ERROR_STATE; }                                     \
+    }                                                                                              \
+    queue_initialize_##MSG_TYPE##_##DEPTH(&sub->ring);                                             \
+    sub->policy = policy;                                                                          \
+    sub->topic = topic;                                                                            \
+    sub->delivered = 0;                                                                            \
+    sub->dropped = 0;                                                                              \
+    HOL_BUS_LOCK();                                                                                \
+    t->subs[t->sub_count++] = sub;                                                                 \
+    if (policy == HOL_BUS_REJECT) { t->reject_count++; }                                           \
+    HOL_BUS_UNLOCK();                                                                              \
+    return HOL_BUS_OK;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+static inline hol_bus_status_t NAME##_bus_unsubscribe(NAME##_bus_t* bus, NAME##_bus_sub_t* sub)    \
+{                                                                                                  \
+    if (!bus || !sub) { return HOL_BUS_ERROR_NULL_POINTER; }                                       \
+    if (sub->topic < 0 || sub->topic >= bus->topic_count) { return HOL_BUS_ERROR_STATE; }          \
+    NAME##_bus_topic_t* t = &bus->topics[sub->topic];                                              \
+    for (uint8_t i = 0; i < t->sub_count; i++)                                                     \
+    {                                                                                              \
+        if (t->subs[i] != sub) { continue; }                                                       \
+        HOL_BUS_LOCK();                                                                            \
+        t->subs[i] = t->subs[--t->sub_count];                                                      \
+        if (sub->policy == HOL_BUS_REJECT) { t->reject_count--; }                                  \
+        HOL_BUS_UNLOCK();                                                                          \
+        sub->topic = HOL_BUS_INVALID_TOPIC;                                                        \
+        return HOL_BUS_OK;                                                                         \
+    }                                                                                              \
+    return HOL_BUS_ERROR_STATE;                                                                    \
+}                                                                                                  \
+                                                                                                   \
+/* Give a topic a shared broadcast ring (readers attach with NAME_bus_attach) */                   \
+static inline hol_bus_status_t NAME##_bus_set_broadcast(NAME##_bus_t* bus, hol_bus_topic_t topic,  \
+                                                        NAME##_bus_broadcast_t* ring)              \
+{                                                                                                  \
+    if (!bus || !ring) { return HOL_BUS_ERROR_NULL_POINTER; }                                      \
+    if (topic < 0 || topic >= bus->topic_count) { return HOL_BUS_ERROR_TOPIC; }                    \
+    ring->write_seq = 0;                                                                           \
+    bus->topics[topic].broadcast = ring;                                                           \
+    return HOL_BUS_OK;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+/* Start reading a topic's broadcast ring; only messages published from now on are seen */         \
+static inline hol_bus_status_t NAME##_bus_attach(NAME##_bus_t* bus, hol_bus_topic_t topic,         \
+                                                 NAME##_bus_reader_t* reader)                      \
+{                                                                                                  \
+    if (!bus || !reader) { return HOL_BUS_ERROR_NULL_POINTER; }                                    \
+    if (topic < 0 || topic >= bus->topic_count || !bus->topics[topic].broadcast)                   \
+    {                                                                                              \
+        return HOL_BUS_ERROR_TOPIC;                                                                \
+    }                                                                                              \
+    reader->ring = bus->topics[topic].broadcast;                                                   \
+    reader->read_seq = reader->ring->write_seq;                                                    \
+    reader->received = 0;                                                                          \
+    reader->lost = 0;                                                                              \
+    return HOL_BUS_OK;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+/**                                                                                                \
+ * Deliver msg to every subscriber of topic (and its broadcast ring).                              \
+ * HOL_BUS_ERROR_FULL: a HOL_BUS_REJECT subscriber had no room; nothing was delivered.             \
+ */                                                                                                \
+static inline hol_bus_status_t NAME##_bus_publish(NAME##_bus_t* bus, hol_bus_topic_t topic,        \
+                                                  const MSG_TYPE* msg)                             \
+{                                                                                                  \
+    if (!bus || !msg) { return HOL_BUS_ERROR_NULL_POINTER; }                                       \
+    if (topic < 0 || topic >= bus->topic_count) { return HOL_BUS_ERROR_TOPIC; }                    \
+    NAME##_bus_topic_t* t = &bus->topics[topic];                                                   \
+    HOL_BUS_LOCK();                                                                                \
+    if (t->reject_count != 0)                                                                      \
+    {                                                                                              \
+        for (uint8_t i = 0; i < t->sub_count; i++)                                                 \
+        {                                                                                          \
+            if (t->subs[i]->policy == HOL_BUS_REJECT &&                                            \
+                queue_is_full_##MSG_TYPE##_##DEPTH(&t->subs[i]->ring))                             \
+            {                                                                                      \
+                t->rejected++;                                                                     \
+                HOL_BUS_UNLOCK();                                                                  \
+                return HOL_BUS_ERROR_FULL;                                                         \
+            }                                                                                      \
+        }                                                                                          \
+    }                                                                                              \
+    for (uint8_t i = 0; i < t->sub_count; i++)                                                     \
+    {                                                                                              \
+        NAME##_bus_sub_t* sub = t->subs[i];                                                        \
+        if (queue_is_full_##MSG_TYPE##_##DEPTH(&sub->ring))                                        \
+        {                                                                                          \
+            sub->dropped++;                                                                        \
+            if (sub->policy == HOL_BUS_DROP_NEWEST) { continue; }                                  \
+        }                                                                                          \
+        sub->delivered++;                                                                          \
+        queue_push_##MSG_TYPE##_##DEPTH(&sub->ring, *msg);                                         \
+    }                                                                                              \
+    if (t->broadcast)                                                                              \
+    {                                                                                              \
+        t->broadcast->slots[t->broadcast->write_seq % DEPTH] = *msg;                               \
+        t->broadcast->write_seq++;                                                                 \
+    }                                                                                              \
+    t->published++;                                                                                \
+    HOL_BUS_UNLOCK();                                                                              \
+    return HOL_BUS_OK;                                                                             \
+}                                                                                                  \
+                                                                                                   \
+/* Take the oldest message from a ring subscriber */                                               \
+static inline bool NAME##_bus_receive(NAME##_bus_sub_t* sub, MSG_TYPE* out)                        \
+{                                                                                                  \
+    HOL_BUS_LOCK();                                                                                \
+    queue_##MSG_TYPE##_##DEPTH##_status_e status =                                                 \
+        queue_pull_##MSG_TYPE##_##DEPTH(&sub->ring, out);                                          \
+    HOL_BUS_UNLOCK();                                                                              \
+    return status == QUEUE_##MSG_TYPE##_##DEPTH##_OK;                                              \
+}                                                                                                  \
+                                                                                                   \
+static inline size_t NAME##_bus_pending(const NAME##_bus_sub_t* sub)                               \
+{                                                                                                  \
+    return sub ? queue_count_##MSG_TYPE##_##DEPTH(&sub->ring) : 0;                                 \
+}                                                                                                  \
+                                                                                                   \
+/* Next message from a broadcast ring; a lapped reader skips ahead (skipped = lost) */             \
+static inline bool NAME##_bus_read(NAME##_bus_reader_t* reader, MSG_TYPE* out)                     \
+{                                                                                                  \
+    bool ok = false;                                                                               \
+    HOL_BUS_LOCK();                                                                                \
+    uint32_t behind = reader->ring->write_seq - reader->read_seq;                                  \
+    if (behind > DEPTH)                                                                            \
+    {                                                                                              \
+        reader->lost += behind - DEPTH;                                                            \
+        reader->read_seq = reader->ring->write_seq - DEPTH;                                        \
+    }                                                                                              \
+    if (behind != 0)                                                                               \
+    {                                                                                              \
+        *out = reader->ring->slots[reader->read_seq % DEPTH];                                      \
+        reader->read_seq++;                                                                        \
+        reader->received++;                                                                        \
+        ok = true;                                                                                 \
+    }                                                                                              \
+    HOL_BUS_UNLOCK();                                                                              \
+    return ok;                                                                                     \
+}
+
+#endif /* HOL_BUS_H */
@@ -0,0 +1,314 @@
+/**
+ * @file HOL_LogCompress.h
+ * @brief Self-contained LZ77 block compressor (LZ4-class format) for log streams
+ *
+ * @section Features
+ * - Zero dynamic memory: the caller owns the hash table and buffers
+ * - Independent blocks: any block can be decoded on its own (seekable files)
+ * - Greedy single-pass matcher with 4-byte hashing, 64 KB window
+ * - Bounds-checked decoder (corrupt input never writes out of range)
+ *
+ * @section Sequence_Format
+ * A block payload is a list of sequences:
+ *   token (u8)           high nibble: literal length, low nibble: match length - 4
+ *   [literal length+]    extra bytes when the nibble is 15 (255 = keep adding)
+ *   literals
+ *   offset (u16 LE)      distance back to the match (omitted after the last literals)
+ *   [match length+]      extra bytes when the nibble is 15
+ * The last sequence carries literals only; the payload ends right after them.
+ *
+ * @section Frame_Format
+ * Each framed block: 'H' 'L' 'Z' '1', raw length (u32 LE),
+ * stored length (u32 LE, bit 31 set = payload stored uncompressed), payload.
+ *
+ * @section Usage_Example
+ * @code
+ * static hol_lz_state_t lz;
+ * static uint8_t framed[HOL_LZ_FRAME_BOUND(4096)];
+ *
+ * size_t n = hol_lz_frame_encode(&lz, raw, raw_len, framed, sizeof(framed));
+ * write(fd, framed, n);
+ *
+ * size_t used;
+ * long out = hol_lz_frame_decode(framed, n, raw_out, sizeof(raw_out), &used);
+ * @endcode
+ */
+
+#ifndef HOL_LOG_COMPRESS_H
+#define HOL_LOG_COMPRESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * @brief Hash table size as a power of two (RAM: 4 << HOL_LZ_HASH_BITS bytes)
+ * @note 12 bits = 16 KB: good ratio on log text. Use 10 on small MCUs.
+ */
+#ifndef HOL_LZ_HASH_BITS
+#define HOL_LZ_HASH_BITS 12
+#endif
+
+#define HOL_LZ_MIN_MATCH     4
+#define HOL_LZ_MAX_OFFSET    65535u
+#define HOL_LZ_FRAME_HEADER  12u
+#define HOL_LZ_STORED_FLAG   0x80000000u
+
+/**
+ * @brief Worst-case compressed payload size for n input bytes
+ */
+#define HOL_LZ_BOUND(n)        ((n) + (n) / 255u + 16u)
+
+/**
+ * @brief Worst-case framed block size for n input bytes
+ */
+#define HOL_LZ_FRAME_BOUND(n)  (HOL_LZ_FRAME_HEADER + HOL_LZ_BOUND(n))
+
+/**
+ * @brief Compressor state (hash of 4-byte sequences -> position + 1)
+ */
+typedef struct {
+    uint32_t table[1u << HOL_LZ_HASH_BITS];
+} hol_lz_state_t;
+
+static inline uint32_t hol_lz_read32(const uint8_t* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hol_lz_hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - HOL_LZ_HASH_BITS);
+}
+
+/* Write a length nibble overflow as 255-runs; false when out of room */
+static inline bool hol_lz_put_length(uint8_t* dst, size_t cap, size_t* op, size_t len)
+{
+    while (len >= 255u)
+    {
+        if (*op >= cap) { return false; }
+        dst[(*op)++] = 255u;
+        len -= 255u;
+    }
+    if (*op >= cap) { return false; }
+    dst[(*op)++] = (uint8_t)len;
+    return true;
+}
+
+/* Emit one sequence: literals src[anchor..anchor+lit_len), then an optional match */
+static inline bool hol_lz_put_sequence(uint8_t* dst, size_t cap, size_t* op,
+                                       const uint8_t* literals, size_t lit_len,
+                                       size_t offset, size_t match_len)
+{
+    size_t match_code = (match_len != 0) ? match_len - HOL_LZ_MIN_MATCH : 0;
+    if (*op >= cap) { return false; }
+    dst[(*op)++] = (uint8_t)(((lit_len < 15u ? lit_len : 15u) << 4) |
+                             (match_code < 15u ? match_code : 15u));
+    if (lit_len >= 15u && !hol_lz_put_length(dst, cap, op, lit_len - 15u)) { return false; }
+
+    if (lit_len > cap - *op) { return false; }
+    memcpy(&dst[*op], literals, lit_len);
+    *op += lit_len;
+
+    if (match_len == 0) { return true; }
+    if (cap - *op < 2) { return false; }
+    dst[(*op)++] = (uint8_t)offset;
+    dst[(*op)++] = (uint8_t)(offset >> 8);
+    if (match_code >= 15u && !hol_lz_put_length(dst, cap, op, match_code - 15u)) { return false; }
+    return true;
+}
+
+/**
+ * @brief Compress one independent block
+ * @param state Hash table (reset on every call, so blocks stay independent)
+ * @param src   Input bytes
+ * @param n     Input length
+ * @param dst   Output buffer
+ * @param cap   Output capacity (HOL_LZ_BOUND(n) always suffices)
+ * @return Compressed size, or 0 if it does not fit in cap
+ */
+static inline size_t hol_lz_compress(hol_lz_state_t* state, const uint8_t* src, size_t n,
+                                     uint8_t* dst, size_t cap)
+{
+    size_t ip = 0;
+    size_t anchor = 0;
+    size_t op = 0;
+
+    memset(state->table, 0, sizeof(state->table));
+
+    while (ip + HOL_LZ_MIN_MATCH <= n)
+    {
+        uint32_t sequence = hol_lz_read32(&src[ip]);
+        uint32_t h = hol_lz_hash(sequence);
+        size_t candidate = state->table[h];
+        state->table[h] = (uint32_t)(ip + 1);
+
+        if (candidate == 0 || ip - (candidate - 1) > HOL_LZ_MAX_OFFSET ||
+            hol_lz_read32(&src[candidate - 1]) != sequence)
+        {
+            /* Skip faster through incompressible data */
+            ip += 1 + ((ip - anchor) >> 6);
+            continue;
+        }
+
+        candidate--;
+        size_t len = HOL_LZ_MIN_MATCH;
+        while (ip + len < n && src[candidate + len] == src[ip + len]) { len++; }
+
+        if (!hol_lz_put_sequence(dst, cap, &op, &src[anchor], ip - anchor, ip - candidate, len))
+        {
+            return 0;
+        }
+        ip += len;
+        anchor = ip;
+    }
+
+    if (!hol_lz_put_sequence(dst, cap, &op, &src[anchor], n - anchor, 0, 0)) { return 0; }
+    return op;
+}
+
+/* Read a 255-run length extension; false on truncated input */
+static inline bool hol_lz_get_length(const uint8_t* src, size_t n, size_t* ip, size_t* len)
+{
+    uint8_t byte;
+    do
+    {
+        if (*ip >= n) { return false; }
+        byte = src[(*ip)++];
+        *len += byte;
+    } while (byte == 255u);
+    return true;
+}
+
+/**
+ * @brief Decompress one block
+ * @param src Compressed payload
+ * @param n   Payload length
+ * @param dst Output buffer
+ * @param cap Output capacity
+ * @return Decompressed size, or -1 on corrupt input / insufficient capacity
+ */
+static inline long hol_lz_decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t cap)
+{
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < n)
+    {
+        uint8_t token = src[ip++];
+
+        size_t lit_len = token >> 4;
+        if (lit_len == 15u && !hol_lz_get_length(src, n, &ip, &lit_len)) { return -1; }
+        if (lit_len > n - ip || lit_len > cap - op) { return -1; }
+        memcpy(&dst[op], &src[ip], lit_len);
+        ip += lit_len;
+        op += lit_len;
+
+        if (ip == n) { break; }   /* Last sequence: literals only */
+
+        if (n - ip < 2) { return -1; }
+        size_t offset = (size_t)src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+        size_t match_len = token & 0x0Fu;
+        if (match_len == 15u && !hol_lz_get_length(src, n, &ip, &match_len)) { return -1; }
+        match_len += HOL_LZ_MIN_MATCH;
+
+        if (offset == 0 || offset > op || match_len > cap - op) { return -1; }
+        const uint8_t* match = &dst[op - offset];
+        if (offset >= match_len)
+        {
+            memcpy(&dst[op], match, match_len);
+        }
+        else
+        {
+            /* Overlapping match (run-length style): copy forward byte by byte */
+            for (size_t i = 0; i < match_len; i++) { dst[op + i] = match[i]; }
+        }
+        op += match_len;
+    }
+    return (long)op;
+}
+
+static inline void hol_lz_put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t hol_lz_get_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Compress a block and wrap it in a frame header
+ * @return Framed size (stored uncompressed if compression does not help),
+ *         or 0 if cap < HOL_LZ_FRAME_BOUND(n)
+ */
+static inline size_t hol_lz_frame_encode(hol_lz_state_t* state, const uint8_t* src, size_t n,
+                                         uint8_t* dst, size_t cap)
+{
+    if (cap < HOL_LZ_FRAME_HEADER) { return 0; }
+
+    size_t packed = hol_lz_compress(state, src, n, &dst[HOL_LZ_FRAME_HEADER],
+                                    cap - HOL_LZ_FRAME_HEADER);
+    uint32_t stored = (uint32_t)packed;
+    if (packed == 0 || packed >= n)
+    {
+        if (cap - HOL_LZ_FRAME_HEADER < n) { return 0; }
+        memcpy(&dst[HOL_LZ_FRAME_HEADER], src, n);
+        packed = n;
+        stored = (uint32_t)n | HOL_LZ_STORED_FLAG;
+    }
+
+    dst[0] = 'H';
+    dst[1] = 'L';
+    dst[2] = 'Z';
+    dst[3] = '1';
+    hol_lz_put_u32(&dst[4], (uint32_t)n);
+    hol_lz_put_u32(&dst[8], stored);
+    return HOL_LZ_FRAME_HEADER + packed;
+}
+
+/**
+ * @brief Decode one framed block
+ * @param src      Input starting at a frame header
+ * @param n        Bytes available at src
+ * @param dst      Output buffer
+ * @param cap      Output capacity
+ * @param consumed Set to the framed size on success
+ * @return Raw block size, or -1 on a bad frame / truncated input / small dst
+ */
+static inline long hol_lz_frame_decode(const uint8_t* src, size_t n, uint8_t* dst, size_t cap,
+                                       size_t* consumed)
+{
+    if (n < HOL_LZ_FRAME_HEADER || memcmp(src, "HLZ1", 4) != 0) { return -1; }
+
+    uint32_t raw = hol_lz_get_u32(&src[4]);
+    uint32_t stored = hol_lz_get_u32(&src[8]);
+    size_t payload = stored & ~HOL_LZ_STORED_FLAG;
+    if (payload > n - HOL_LZ_FRAME_HEADER || raw > cap) { return -1; }
+
+    long out;
+    if (stored & HOL_LZ_STORED_FLAG)
+    {
+        if (payload != raw) { return -1; }
+        memcpy(dst, &src[HOL_LZ_FRAME_HEADER], payload);
+        out = (long)payload;
+    }
+    else
+    {
+        out = hol_lz_decompress(&src[HOL_LZ_FRAME_HEADER], payload, dst, raw);
+        if (out != (long)raw) { return -1; }
+    }
+
+    *consumed = HOL_LZ_FRAME_HEADER + payload;
+    return out;
+}
+
+#endif /* HOL_LOG_COMPRESS_H */
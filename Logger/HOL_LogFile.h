@@ -0,0 +1,440 @@
+/**
+ * @file HOL_LogFile.h
+ * @brief File sink for HOL_Logger with an optional sidecar time index (POSIX hosts)
+ *
+ * @section Features
+ * - Buffered line writes to a POSIX file descriptor
+ * - Optional sidecar index: timestamp -> byte offset every N bytes or N ms
+ * - Cumulative per-level line counts stored with every index entry
+ * - Optional LZ77 block compression (LOG_FILE_COMPRESSION, HOL_LogCompress.h)
+ * - Plugs into any TAG through TAG_set_line_sink()
+ *
+ * @section Index_Format
+ * All integers little-endian.
+ * - Header (16 bytes): 'H' 'O' 'L' 'I', version (u32), entry size (u32), flags (u32)
+ * - Entry  (32 bytes): timestamp_ms (u64), offset (u64), lines[4] (u32, DEBUG..ERROR)
+ *
+ * An entry says: "the line starting at `offset` was written at `timestamp_ms`,
+ * and `lines[level]` lines of each level were written before it". Entries are
+ * appended in time order, so a reader can binary-search them and read only the
+ * byte range of interest (see Tools/hol_log_query.c).
+ *
+ * Counts stay cumulative for the life of the index: reopening an existing
+ * index resumes them from its last entry, and close appends a final entry
+ * when lines were written after the last one.
+ *
+ * With LOG_FILE_INDEX_COMPRESSED set in the header flags, the log file is a
+ * sequence of independent HLZ1 frames and every index entry points at the
+ * start of a frame, so any window can be decoded without reading earlier data.
+ *
+ * @section Usage_Example
+ * @code
+ * #include "HOL_Logger.h"
+ * #include "HOL_LogFile.h"
+ * DECLARE_LOG(APP, 256, void)
+ *
+ * hol_log_file_t log_file;
+ *
+ * int main(void) {
+ *     // Index entry at least every 64 KB or every second
+ *     hol_log_file_open(&log_file, "app.log", "app.log.idx", 64 * 1024, 1000);
+ *     APP_set_line_sink(hol_log_file_line_sink, &log_file);
+ *     APP_LOG_INFO("Service started");
+ *     hol_log_file_close(&log_file);
+ * }
+ * @endcode
+ *
+ * @warning NOT thread-safe - one writer per hol_log_file_t
+ */
+
+#ifndef HOL_LOG_FILE_H
+#define HOL_LOG_FILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Write buffer per file sink (bytes)
+ */
+#ifndef LOG_FILE_BUFFER_SIZE
+#define LOG_FILE_BUFFER_SIZE 8192
+#endif
+
+/**
+ * @brief Enable block compression support (adds a compressor to every file sink)
+ * @note With compression, LOG_FILE_BUFFER_SIZE is the block size: 32-64 KB
+ *       gives a good ratio on log text.
+ */
+#ifndef LOG_FILE_COMPRESSION
+#define LOG_FILE_COMPRESSION 0
+#endif
+
+#if LOG_FILE_COMPRESSION
+#include "HOL_LogCompress.h"
+#endif
+
+#define LOG_FILE_INDEX_VERSION      1u
+#define LOG_FILE_INDEX_HEADER_SIZE  16u
+#define LOG_FILE_INDEX_ENTRY_SIZE   32u
+#define LOG_FILE_LEVELS             4u
+#define LOG_FILE_INDEX_COMPRESSED   0x1u   /* Index header flag: log is HLZ1 frames */
+
+/**
+ * @brief Millisecond clock for index timestamps (NULL: CLOCK_REALTIME)
+ */
+typedef uint64_t (*hol_log_file_clock_t)(void);
+
+/**
+ * @brief One decoded sidecar index entry
+ */
+typedef struct {
+    uint64_t timestamp_ms;
+    uint64_t offset;
+    uint32_t lines[LOG_FILE_LEVELS];
+} hol_log_index_entry_t;
+
+/**
+ * @brief File sink state
+ */
+typedef struct {
+    int      fd;                              /* Log file */
+    int      index_fd;                        /* Sidecar index, -1 = disabled */
+    uint64_t offset;                          /* File offset of the next line (or block) */
+    uint64_t last_index_offset;               /* Offset of the last index entry */
+    uint64_t last_index_ms;                   /* Timestamp of the last index entry */
+    uint64_t raw_since_index;                 /* Uncompressed bytes since the last entry */
+    uint32_t index_every_bytes;               /* 0 = no byte trigger */
+    uint32_t index_every_ms;                  /* 0 = no time trigger */
+    uint32_t lines[LOG_FILE_LEVELS];          /* Lines written per level */
+    uint32_t write_errors;                    /* Failed write() calls */
+    bool     indexed_once;                    /* First line always gets an entry */
+    hol_log_file_clock_t clock;
+    size_t   buffered;                        /* Bytes waiting in buffer */
+    char     buffer[LOG_FILE_BUFFER_SIZE];
+#if LOG_FILE_COMPRESSION
+    bool     compress;                        /* buffer holds one raw block */
+    hol_lz_state_t lz;
+    uint8_t  frame[HOL_LZ_FRAME_BOUND(LOG_FILE_BUFFER_SIZE)];
+#endif
+} hol_log_file_t;
+
+/* Little-endian field writers and reader for the index */
+static inline void hol_log_file_put_u32(uint8_t* p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) { p[i] = (uint8_t)(v >> (8 * i)); }
+}
+
+static inline void hol_log_file_put_u64(uint8_t* p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) { p[i] = (uint8_t)(v >> (8 * i)); }
+}
+
+static inline uint32_t hol_log_file_get_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Decode one 32-byte index entry
+ */
+static inline void hol_log_index_decode(const uint8_t* p, hol_log_index_entry_t* entry)
+{
+    entry->timestamp_ms = 0;
+    entry->offset = 0;
+    for (int i = 7; i >= 0; i--)
+    {
+        entry->timestamp_ms = (entry->timestamp_ms << 8) | p[i];
+        entry->offset = (entry->offset << 8) | p[8 + i];
+    }
+    for (unsigned l = 0; l < LOG_FILE_LEVELS; l++)
+    {
+        entry->lines[l] = hol_log_file_get_u32(&p[16 + 4 * l]);
+    }
+}
+
+/* write() the whole range, retrying on EINTR and short writes */
+static inline bool hol_log_file_write_all(int fd, const char* data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+static inline uint64_t hol_log_file_now_ms(const hol_log_file_t* file)
+{
+    if (file->clock != NULL) { return file->clock(); }
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+/* Write raw bytes; in compressed mode they become framed blocks of <= one buffer */
+static inline void hol_log_file_write_block(hol_log_file_t* file, const char* data, size_t len)
+{
+#if LOG_FILE_COMPRESSION
+    if (file->compress)
+    {
+        /* A frame holds at most one buffer: longer lines span several frames */
+        while (len > 0)
+        {
+            size_t chunk = (len < sizeof(file->buffer)) ? len : sizeof(file->buffer);
+            size_t framed = hol_lz_frame_encode(&file->lz, (const uint8_t*)data, chunk,
+                                                file->frame, sizeof(file->frame));
+            if (framed == 0 ||
+                !hol_log_file_write_all(file->fd, (const char*)file->frame, framed))
+            {
+                file->write_errors++;
+                return;
+            }
+            file->offset += framed;
+            data += chunk;
+            len -= chunk;
+        }
+        return;
+    }
+#endif
+    if (!hol_log_file_write_all(file->fd, data, len)) { file->write_errors++; }
+}
+
+/**
+ * @brief Write buffered lines to the file (closes the current block when compressing)
+ */
+static inline void hol_log_file_flush(hol_log_file_t* file)
+{
+    if (file->buffered == 0) { return; }
+    hol_log_file_write_block(file, file->buffer, file->buffered);
+    file->buffered = 0;
+}
+
+/* Append an index entry for the line about to be written at file->offset */
+static inline void hol_log_file_index(hol_log_file_t* file, uint64_t now_ms)
+{
+    uint8_t entry[LOG_FILE_INDEX_ENTRY_SIZE];
+    hol_log_file_put_u64(&entry[0], now_ms);
+    hol_log_file_put_u64(&entry[8], file->offset);
+    for (unsigned l = 0; l < LOG_FILE_LEVELS; l++)
+    {
+        hol_log_file_put_u32(&entry[16 + 4 * l], file->lines[l]);
+    }
+    if (!hol_log_file_write_all(file->index_fd, (const char*)entry, sizeof(entry)))
+    {
+        file->write_errors++;
+    }
+    file->last_index_offset = file->offset;
+    file->last_index_ms = now_ms;
+    file->raw_since_index = 0;
+    file->indexed_once = true;
+}
+
+/* True if fd starts with a HOL index header of this version written with `flags` */
+static inline bool hol_log_file_index_matches(int fd, uint32_t flags)
+{
+    uint8_t header[LOG_FILE_INDEX_HEADER_SIZE];
+    if (pread(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header)) { return false; }
+
+    return memcmp(header, "HOLI", 4) == 0 &&
+           hol_log_file_get_u32(&header[4]) == LOG_FILE_INDEX_VERSION &&
+           hol_log_file_get_u32(&header[8]) == LOG_FILE_INDEX_ENTRY_SIZE &&
+           (hol_log_file_get_u32(&header[12]) & LOG_FILE_INDEX_COMPRESSED) ==
+               (flags & LOG_FILE_INDEX_COMPRESSED);
+}
+
+/* Common open path; flags are stored in the index header */
+static inline int hol_log_file_open_ex(hol_log_file_t* file, const char* path,
+                                       const char* index_path, uint32_t every_bytes,
+                                       uint32_t every_ms, uint32_t flags)
+{
+    memset(file, 0, sizeof(*file));
+    file->index_fd = -1;
+    file->index_every_bytes = every_bytes;
+    file->index_every_ms = every_ms;
+
+    file->fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (file->fd < 0) { return -1; }
+
+    off_t size = lseek(file->fd, 0, SEEK_END);
+    file->offset = (size > 0) ? (uint64_t)size : 0u;
+
+    if (index_path != NULL)
+    {
+        file->index_fd = open(index_path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (file->index_fd < 0)
+        {
+            close(file->fd);
+            file->fd = -1;
+            return -1;
+        }
+        off_t index_size = lseek(file->index_fd, 0, SEEK_END);
+        if (index_size != 0 && !hol_log_file_index_matches(file->index_fd, flags))
+        {
+            /* Not a HOL index, or written in the other mode (plain vs compressed) */
+            close(file->index_fd);
+            close(file->fd);
+            file->index_fd = -1;
+            file->fd = -1;
+            errno = EINVAL;
+            return -1;
+        }
+        if (index_size >= (off_t)(LOG_FILE_INDEX_HEADER_SIZE + LOG_FILE_INDEX_ENTRY_SIZE))
+        {
+            /* Resume the cumulative counts from the last entry */
+            uint8_t last[LOG_FILE_INDEX_ENTRY_SIZE];
+            off_t entries = (index_size - LOG_FILE_INDEX_HEADER_SIZE) / LOG_FILE_INDEX_ENTRY_SIZE;
+            off_t at = LOG_FILE_INDEX_HEADER_SIZE + (entries - 1) * LOG_FILE_INDEX_ENTRY_SIZE;
+            if (pread(file->index_fd, last, sizeof(last), at) == (ssize_t)sizeof(last))
+            {
+                hol_log_index_entry_t entry;
+                hol_log_index_decode(last, &entry);
+                memcpy(file->lines, entry.lines, sizeof(file->lines));
+            }
+            else
+            {
+                file->write_errors++;
+            }
+        }
+        else if (index_size == 0)
+        {
+            uint8_t header[LOG_FILE_INDEX_HEADER_SIZE] = { 'H', 'O', 'L', 'I' };
+            hol_log_file_put_u32(&header[4], LOG_FILE_INDEX_VERSION);
+            hol_log_file_put_u32(&header[8], LOG_FILE_INDEX_ENTRY_SIZE);
+            hol_log_file_put_u32(&header[12], flags);
+            if (!hol_log_file_write_all(file->index_fd, (const char*)header, sizeof(header)))
+            {
+                file->write_errors++;
+            }
+        }
+    }
+#if LOG_FILE_COMPRESSION
+    file->compress = (flags & LOG_FILE_INDEX_COMPRESSED) != 0;
+#endif
+    return 0;
+}
+
+/**
+ * @brief Open (append to) a log file and optionally its sidecar index
+ * @param file        Sink state
+ * @param path        Log file path
+ * @param index_path  Sidecar index path, NULL to disable indexing
+ * @param every_bytes Add an index entry after at least this many bytes (0 = off)
+ * @param every_ms    Add an index entry after at least this many ms (0 = off)
+ * @return 0 on success, -1 on error (errno set; EINVAL: the existing index is
+ *         not a HOL index or was written by the other open mode)
+ *
+ * @note Appending to an existing log requires its existing index, otherwise
+ *       the offsets restart from the current file size with no earlier entries.
+ *       Per-level counts continue from the last entry of an existing index.
+ */
+static inline int hol_log_file_open(hol_log_file_t* file, const char* path, const char* index_path,
+                                    uint32_t every_bytes, uint32_t every_ms)
+{
+    return hol_log_file_open_ex(file, path, index_path, every_bytes, every_ms, 0);
+}
+
+#if LOG_FILE_COMPRESSION
+/**
+ * @brief Open a compressed log file: lines are packed into independent LZ77 blocks
+ * @note Same parameters as hol_log_file_open(). Each index entry starts a new
+ *       block, so every_bytes / every_ms also bound the block size. Blocks are
+ *       compressed in the context that calls the sink (e.g. TAG_log_flush()).
+ */
+static inline int hol_log_file_open_compressed(hol_log_file_t* file, const char* path,
+                                               const char* index_path, uint32_t every_bytes,
+                                               uint32_t every_ms)
+{
+    return hol_log_file_open_ex(file, path, index_path, every_bytes, every_ms,
+                                LOG_FILE_INDEX_COMPRESSED);
+}
+#endif
+
+/**
+ * @brief Line sink: buffer one line, adding an index entry when one is due
+ * @note Signature matches hol_log_line_sink_t; pass the hol_log_file_t as ctx.
+ */
+static inline void hol_log_file_line_sink(void* ctx, int level, const char* line, size_t len)
+{
+    hol_log_file_t* file = (hol_log_file_t*)ctx;
+    if (file == NULL || file->fd < 0) { return; }
+
+    if (file->index_fd >= 0)
+    {
+        /* Raw line bytes: in compressed mode offset only moves per block */
+        bool due = !file->indexed_once ||
+                   (file->index_every_bytes != 0 &&
+                    file->raw_since_index >= file->index_every_bytes);
+        uint64_t now_ms = 0;
+        if (!due && file->index_every_ms != 0)
+        {
+            now_ms = hol_log_file_now_ms(file);
+            due = (now_ms - file->last_index_ms >= file->index_every_ms);
+        }
+        if (due)
+        {
+            if (now_ms == 0) { now_ms = hol_log_file_now_ms(file); }
+#if LOG_FILE_COMPRESSION
+            /* Index entries must point at a block start */
+            if (file->compress) { hol_log_file_flush(file); }
+#endif
+            hol_log_file_index(file, now_ms);
+        }
+    }
+
+    if (len > sizeof(file->buffer) - file->buffered) { hol_log_file_flush(file); }
+    if (len > sizeof(file->buffer))
+    {
+        hol_log_file_write_block(file, line, len);
+    }
+    else
+    {
+        memcpy(&file->buffer[file->buffered], line, len);
+        file->buffered += len;
+    }
+
+#if LOG_FILE_COMPRESSION
+    if (!file->compress) { file->offset += len; }
+#else
+    file->offset += len;
+#endif
+    file->raw_since_index += len;
+    if ((unsigned)level < LOG_FILE_LEVELS) { file->lines[level]++; }
+}
+
+/**
+ * @brief Flush and close the log file and its index
+ * @note Lines written after the last index entry get a closing entry, so a
+ *       later reopen resumes exact per-level counts.
+ */
+static inline void hol_log_file_close(hol_log_file_t* file)
+{
+    if (file->fd < 0) { return; }
+    hol_log_file_flush(file);
+    close(file->fd);
+    file->fd = -1;
+    if (file->index_fd >= 0)
+    {
+        if (file->raw_since_index > 0)
+        {
+            uint64_t now_ms = hol_log_file_now_ms(file);
+            hol_log_file_index(file, (now_ms > file->last_index_ms) ? now_ms : file->last_index_ms);
+        }
+        close(file->index_fd);
+        file->index_fd = -1;
+    }
+}
+
+#endif /* HOL_LOG_FILE_H */
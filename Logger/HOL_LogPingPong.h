@@ -0,0 +1,214 @@
+/**
+ * @file HOL_LogPingPong.h
+ * @brief Double-buffered (ping-pong) line sink: formatting overlaps transmission
+ *
+ * @section Features
+ * - Two buffers: lines are appended to one while the driver sends the other
+ * - Asynchronous drivers (DMA, UART interrupt, socket writer thread) report
+ *   completion with hol_log_pingpong_tx_done(), safe from an ISR
+ * - Idle driver: a line starts transmitting at once; busy driver: lines are
+ *   batched and go out together on the next swap
+ * - Callers wait only when both buffers are full (or drop, if no wait hook)
+ * - Works with blocking drivers too (tx_done() called inside start())
+ * - Plugs into any TAG through TAG_set_line_sink()
+ *
+ * @section Usage_Example
+ * @code
+ * #include "HOL_Logger.h"
+ * #include "HOL_LogPingPong.h"
+ * DECLARE_LOG(APP, 128, void)
+ *
+ * static hol_log_pingpong_t uart_log;
+ *
+ * static bool uart_start(void* ctx, const char* data, size_t len) {
+ *     return HAL_UART_Transmit_DMA(&huart2, (const uint8_t*)data, len) == HAL_OK;
+ * }
+ * void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) {
+ *     hol_log_pingpong_tx_done(&uart_log);
+ * }
+ *
+ * int main(void) {
+ *     hol_log_pingpong_init(&uart_log, uart_start, NULL, NULL);  // NULL wait: drop when full
+ *     APP_set_line_sink(hol_log_pingpong_line_sink, &uart_log);
+ *     while (1) {
+ *         APP_LOG_INFO("Tick");
+ *         hol_log_pingpong_poll(&uart_log);   // Sends lines batched while busy
+ *     }
+ * }
+ * @endcode
+ *
+ * @warning NOT thread-safe - one producer per hol_log_pingpong_t; only
+ *          hol_log_pingpong_tx_done() may run in another context.
+ */
+
+#ifndef HOL_LOG_PINGPONG_H
+#define HOL_LOG_PINGPONG_H
+
+#include "HOL_Logger.h"
+
+/**
+ * @brief Size of each of the two buffers (bytes); RAM is twice this
+ * @note Lines longer than one buffer are cut and keep their final newline.
+ */
+#ifndef LOG_PINGPONG_BUFFER_SIZE
+#define LOG_PINGPONG_BUFFER_SIZE 512
+#endif
+
+/**
+ * @brief Start sending data[0..len) asynchronously
+ * @return false if the transfer could not be started (the batch is discarded)
+ * @note data stays valid until hol_log_pingpong_tx_done() is called.
+ */
+typedef bool (*hol_log_pingpong_start_t)(void* ctx, const char* data, size_t len);
+
+/**
+ * @brief Called repeatedly while a caller waits for a free buffer (yield, WFI, poll)
+ */
+typedef void (*hol_log_pingpong_wait_t)(void* ctx);
+
+/**
+ * @brief Ping-pong sink state
+ */
+typedef struct {
+    hol_log_pingpong_start_t start;           /* Driver: begin a transfer */
+    hol_log_pingpong_wait_t  wait;            /* NULL = drop lines instead of waiting */
+    void*    ctx;                             /* Passed to start and wait */
+    volatile bool busy;                       /* A buffer is being transmitted */
+    uint8_t  active;                          /* Buffer being filled */
+    size_t   fill;                            /* Bytes in the active buffer */
+    uint32_t swaps;                           /* Transfers started */
+    uint32_t waits;                           /* Times a caller waited for a free buffer */
+    uint32_t drops;                           /* Lines dropped (both buffers full, no wait) */
+    uint32_t truncated;                       /* Lines cut to one buffer */
+    uint32_t tx_errors;                       /* start() failures (batch discarded) */
+    char     buffers[2][LOG_PINGPONG_BUFFER_SIZE];
+} hol_log_pingpong_t;
+
+/**
+ * @brief Initialise a ping-pong sink
+ * @param pp    Sink state
+ * @param start Driver function that starts an asynchronous transfer
+ * @param wait  Called while both buffers are full (NULL: drop the line instead)
+ * @param ctx   User context for start and wait
+ */
+static inline void hol_log_pingpong_init(hol_log_pingpong_t* pp, hol_log_pingpong_start_t start,
+                                         hol_log_pingpong_wait_t wait, void* ctx)
+{
+    memset(pp, 0, sizeof(*pp));
+    pp->start = start;
+    pp->wait = wait;
+    pp->ctx = ctx;
+}
+
+/**
+ * @brief Driver completion: the buffer passed to start() may be reused
+ * @note Call from the DMA/UART ISR, the writer thread, or inside start()
+ *       for blocking drivers.
+ */
+static inline void hol_log_pingpong_tx_done(hol_log_pingpong_t* pp)
+{
+    LOG_MEMORY_BARRIER();   /* Driver finished reading before the buffer is released */
+    pp->busy = false;
+}
+
+/* Hand the active buffer to the driver and switch to the other one (driver idle) */
+static inline void hol_log_pingpong_swap(hol_log_pingpong_t* pp)
+{
+    if (pp->fill == 0) { return; }
+
+    const char* data = pp->buffers[pp->active];
+    size_t len = pp->fill;
+    pp->active ^= 1u;
+    pp->fill = 0;
+    pp->swaps++;
+
+    pp->busy = true;
+    LOG_MEMORY_BARRIER();   /* busy visible before the driver can complete */
+    if (!pp->start(pp->ctx, data, len))
+    {
+        pp->tx_errors++;
+        pp->busy = false;
+    }
+}
+
+/**
+ * @brief Line sink: append to the active buffer, start a transfer if the driver is idle
+ * @note Signature matches hol_log_line_sink_t; pass the hol_log_pingpong_t as ctx.
+ */
+static inline void hol_log_pingpong_line_sink(void* ctx, int level, const char* line, size_t len)
+{
+    hol_log_pingpong_t* pp = (hol_log_pingpong_t*)ctx;
+    (void)level;
+    if (pp == NULL || pp->start == NULL || len == 0) { return; }
+
+    bool cut = (len > LOG_PINGPONG_BUFFER_SIZE);
+    if (cut)
+    {
+        len = LOG_PINGPONG_BUFFER_SIZE;
+        pp->truncated++;
+    }
+
+    if (len > LOG_PINGPONG_BUFFER_SIZE - pp->fill)
+    {
+        /* Active buffer full: it can only go out once the other one is free */
+        if (pp->busy)
+        {
+            if (pp->wait == NULL)
+            {
+                pp->drops++;
+                return;
+            }
+            pp->waits++;
+            while (pp->busy) { pp->wait(pp->ctx); }
+        }
+        LOG_MEMORY_BARRIER();   /* Observe the release before reusing the buffer */
+        hol_log_pingpong_swap(pp);
+    }
+
+    char* dst = &pp->buffers[pp->active][pp->fill];
+    memcpy(dst, line, len);
+    if (cut) { dst[len - 1] = '\n'; }
+    pp->fill += len;
+
+    if (!pp->busy)
+    {
+        LOG_MEMORY_BARRIER();
+        hol_log_pingpong_swap(pp);
+    }
+}
+
+/**
+ * @brief Start sending lines batched while the driver was busy (call from the main loop)
+ * @return Bytes still waiting in the active buffer
+ */
+static inline size_t hol_log_pingpong_poll(hol_log_pingpong_t* pp)
+{
+    if (!pp->busy)
+    {
+        LOG_MEMORY_BARRIER();
+        hol_log_pingpong_swap(pp);
+    }
+    return pp->fill;
+}
+
+/**
+ * @brief Send everything and wait for the last transfer to complete
+ * @return false if nothing could be waited on (no wait hook while busy)
+ */
+static inline bool hol_log_pingpong_flush(hol_log_pingpong_t* pp)
+{
+    while (pp->busy || pp->fill != 0)
+    {
+        if (!pp->busy)
+        {
+            LOG_MEMORY_BARRIER();
+            hol_log_pingpong_swap(pp);
+            continue;
+        }
+        if (pp->wait == NULL) { return false; }
+        pp->wait(pp->ctx);
+    }
+    return true;
+}
+
+#endif /* HOL_LOG_PINGPONG_H */
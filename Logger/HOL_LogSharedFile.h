@@ -0,0 +1,283 @@
+/**
+ * @file HOL_LogSharedFile.h
+ * @brief Fork-safe file sink for HOL_Logger: many processes, one log file (POSIX hosts)
+ *
+ * @section Features
+ * - Whole-line appends: every write() is one O_APPEND call holding only
+ *   complete lines and at most LOG_SHARED_FILE_BATCH (<= PIPE_BUF) bytes
+ * - Lines from different processes never interleave, also when the path
+ *   is a FIFO read by a log collector
+ * - Fork-safe: a pthread_atfork child handler drops the buffer inherited
+ *   from the parent, so pre-fork lines are written once, by the parent
+ * - Owner check on every line and flush covers forks that bypass
+ *   pthread_atfork (raw clone()): the child drops the inherited buffer
+ *   before buffering its first line, so parent lines are never written twice
+ * - One process-wide registry of open sinks (weak symbols on GCC/Clang)
+ * - Plugs into any TAG through TAG_set_line_sink()
+ *
+ * @section Why_Not_HOL_LogFile
+ * hol_log_file_t keeps an 8 KB buffer and a private file offset. Shared by
+ * forked workers, buffers flushed at arbitrary sizes cut lines in half and
+ * a buffer copied by fork() is written by parent and child alike.
+ *
+ * @section Usage_Example
+ * @code
+ * #include "HOL_Logger.h"
+ * #include "HOL_LogSharedFile.h"
+ * DECLARE_LOG(SRV, 256, void)
+ *
+ * static hol_log_shared_file_t shared_log;   // Must not move while open
+ *
+ * int main(void) {
+ *     hol_log_shared_file_open(&shared_log, "server.log");
+ *     SRV_set_line_sink(hol_log_shared_file_line_sink, &shared_log);
+ *     for (int i = 0; i < 4; i++) {
+ *         if (fork() == 0) { worker(); _exit(0); }   // Workers keep the same sink
+ *     }
+ *     SRV_LOG_INFO("Master ready");
+ *     hol_log_shared_file_flush(&shared_log);      // Also from each worker's loop
+ * }
+ * @endcode
+ *
+ * @warning NOT thread-safe - one writer thread per process and sink
+ */
+
+#ifndef HOL_LOG_SHARED_FILE_H
+#define HOL_LOG_SHARED_FILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifndef PIPE_BUF
+#define PIPE_BUF 512   /* POSIX minimum */
+#endif
+
+/**
+ * @brief Largest single write() (bytes); lines are batched up to this size
+ * @note Capped at PIPE_BUF: the size POSIX guarantees to be written in one
+ *       piece to pipes and FIFOs. Linux also serialises O_APPEND writes to a
+ *       regular file per call, so batches never interleave there either.
+ */
+#ifndef LOG_SHARED_FILE_BATCH
+#define LOG_SHARED_FILE_BATCH PIPE_BUF
+#endif
+
+#if LOG_SHARED_FILE_BATCH > PIPE_BUF
+#error "LOG_SHARED_FILE_BATCH must not exceed PIPE_BUF"
+#endif
+
+/**
+ * @brief Open sinks tracked for the fork handler (per process)
+ */
+#ifndef LOG_SHARED_FILE_MAX
+#define LOG_SHARED_FILE_MAX 8
+#endif
+
+/**
+ * @brief Lines at or above this level are written at once (0 = every line)
+ * @note Default ERROR: an error is on disk before a crash can lose it.
+ */
+#ifndef LOG_SHARED_FILE_FLUSH_LEVEL
+#define LOG_SHARED_FILE_FLUSH_LEVEL 3
+#endif
+
+/**
+ * @brief Shared file sink state
+ */
+typedef struct {
+    int      fd;                              /* Log file, O_APPEND */
+    pid_t    owner;                           /* Process the buffered bytes belong to */
+    uint32_t write_errors;                    /* Failed or short write() calls */
+    uint32_t truncated;                       /* Lines cut to LOG_SHARED_FILE_BATCH */
+    uint32_t fork_drops;                      /* Inherited buffers dropped in children */
+    size_t   buffered;                        /* Bytes waiting in buffer */
+    char     buffer[LOG_SHARED_FILE_BATCH];
+} hol_log_shared_file_t;
+
+/**
+ * @brief Registry of open sinks, walked by the fork handler
+ */
+typedef struct {
+    hol_log_shared_file_t* files[LOG_SHARED_FILE_MAX];
+    pthread_mutex_t        lock;
+    pthread_once_t         once;
+} hol_log_shared_registry_t;
+
+/**
+ * @brief One registry shared by all translation units
+ * @note Weak definitions are merged by the linker; other compilers get one
+ *       registry (and fork handler) per translation unit. The symbol name
+ *       carries LOG_SHARED_FILE_MAX, so files built with another value get a
+ *       registry of their own instead of a differently sized one.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_SHARED_FILE_SHARED __attribute__((weak))
+#else
+#define LOG_SHARED_FILE_SHARED static
+#endif
+
+#define LOG_SHARED_FILE_REGISTRY_NAME_(n) hol_log_shared_registry_##n
+#define LOG_SHARED_FILE_REGISTRY_NAME(n)  LOG_SHARED_FILE_REGISTRY_NAME_(n)
+#define hol_log_shared_registry LOG_SHARED_FILE_REGISTRY_NAME(LOG_SHARED_FILE_MAX)
+
+LOG_SHARED_FILE_SHARED hol_log_shared_registry_t hol_log_shared_registry =
+{
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .once = PTHREAD_ONCE_INIT,
+};
+
+/* Drop what the parent had buffered: the parent still owns and writes it */
+static inline void hol_log_shared_file_reset(hol_log_shared_file_t* file, pid_t self)
+{
+    if (file->buffered != 0) { file->fork_drops++; }
+    file->buffered = 0;
+    file->owner = self;
+}
+
+/* pthread_atfork child handler (the child is single-threaded: no locking) */
+static inline void hol_log_shared_file_atfork_child(void)
+{
+    hol_log_shared_registry_t* registry = &hol_log_shared_registry;
+    pid_t self = getpid();
+    for (size_t i = 0; i < LOG_SHARED_FILE_MAX; i++)
+    {
+        if (registry->files[i] != NULL)
+        {
+            hol_log_shared_file_reset(registry->files[i], self);
+        }
+    }
+    /* The parent may have held the lock while forking */
+    (void)pthread_mutex_init(&registry->lock, NULL);
+}
+
+static inline void hol_log_shared_file_install(void)
+{
+    (void)pthread_atfork(NULL, NULL, hol_log_shared_file_atfork_child);
+}
+
+/**
+ * @brief Write buffered lines with a single O_APPEND write()
+ * @note A short write (disk full, signal) is completed with further calls
+ *       and counted in write_errors: only then can a batch be split.
+ */
+static inline void hol_log_shared_file_flush(hol_log_shared_file_t* file)
+{
+    if (file->buffered == 0) { return; }
+
+    /* Second line of defence after the line sink's check: a foreign buffer
+     * holds only the parent's lines */
+    pid_t self = getpid();
+    if (file->owner != self)
+    {
+        hol_log_shared_file_reset(file, self);
+        return;
+    }
+
+    const char* data = file->buffer;
+    size_t len = file->buffered;
+    file->buffered = 0;
+    while (len > 0)
+    {
+        ssize_t n = write(file->fd, data, len);
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+            file->write_errors++;
+            return;
+        }
+        if ((size_t)n < len) { file->write_errors++; }
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+/**
+ * @brief Open (append to) a log file shared with other processes
+ * @param file Sink state; must stay at the same address until closed
+ * @param path Log file (or FIFO) path
+ * @return 0 on success, -1 on error (errno set; ENOSPC: LOG_SHARED_FILE_MAX sinks open)
+ */
+static inline int hol_log_shared_file_open(hol_log_shared_file_t* file, const char* path)
+{
+    memset(file, 0, sizeof(*file));
+    file->owner = getpid();
+
+    hol_log_shared_registry_t* registry = &hol_log_shared_registry;
+    (void)pthread_once(&registry->once, hol_log_shared_file_install);
+
+    pthread_mutex_lock(&registry->lock);
+    size_t slot = 0;
+    while (slot < LOG_SHARED_FILE_MAX && registry->files[slot] != NULL) { slot++; }
+    if (slot == LOG_SHARED_FILE_MAX)
+    {
+        pthread_mutex_unlock(&registry->lock);
+        file->fd = -1;
+        errno = ENOSPC;
+        return -1;
+    }
+
+    file->fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (file->fd >= 0) { registry->files[slot] = file; }
+    pthread_mutex_unlock(&registry->lock);
+    return (file->fd >= 0) ? 0 : -1;
+}
+
+/**
+ * @brief Line sink: batch whole lines, writing before the batch would overflow
+ * @note Signature matches hol_log_line_sink_t; pass the hol_log_shared_file_t
+ *       as ctx. Lines longer than LOG_SHARED_FILE_BATCH are cut and keep
+ *       their final newline.
+ */
+static inline void hol_log_shared_file_line_sink(void* ctx, int level, const char* line, size_t len)
+{
+    hol_log_shared_file_t* file = (hol_log_shared_file_t*)ctx;
+    if (file == NULL || file->fd < 0 || len == 0) { return; }
+
+    /* Forked without the atfork handler (raw clone()): everything buffered so
+     * far is the parent's, so drop it before this process adds its own line */
+    pid_t self = getpid();
+    if (file->owner != self) { hol_log_shared_file_reset(file, self); }
+
+    bool cut = (len > sizeof(file->buffer));
+    if (cut)
+    {
+        len = sizeof(file->buffer);
+        file->truncated++;
+    }
+    if (len > sizeof(file->buffer) - file->buffered) { hol_log_shared_file_flush(file); }
+
+    memcpy(&file->buffer[file->buffered], line, len);
+    file->buffered += len;
+    if (cut) { file->buffer[file->buffered - 1] = '\n'; }
+
+    if (level >= LOG_SHARED_FILE_FLUSH_LEVEL) { hol_log_shared_file_flush(file); }
+}
+
+/**
+ * @brief Flush, close and unregister the sink
+ */
+static inline void hol_log_shared_file_close(hol_log_shared_file_t* file)
+{
+    if (file->fd < 0) { return; }
+    hol_log_shared_file_flush(file);
+
+    hol_log_shared_registry_t* registry = &hol_log_shared_registry;
+    pthread_mutex_lock(&registry->lock);
+    for (size_t i = 0; i < LOG_SHARED_FILE_MAX; i++)
+    {
+        if (registry->files[i] == file) { registry->files[i] = NULL; }
+    }
+    pthread_mutex_unlock(&registry->lock);
+
+    close(file->fd);
+    file->fd = -1;
+}
+
+#endif /* HOL_LOG_SHARED_FILE_H */
@@ -11,12 +11,22 @@
  * - Buffer overflow protection
  * - Runtime log level filtering (enable/disable per level)
  * - Global and per-TAG enable/disable control
+ * - Adaptive load shedding when the sink falls behind
+ * - Deferred mode with per-level priority lanes (DECLARE_LOG_DEFERRED)
+ * - Per-CPU deferred lanes for multi-core producers (DECLARE_LOG_DEFERRED_PERCPU)
+ * - In-memory recent records per level with lock-free snapshots (DECLARE_LOG_RECENT)
+ * - Binary mode: format-string IDs + raw arguments, decoded offline
+ * - Level-aware line sinks (file sink with sidecar index: HOL_LogFile.h)
+ * - Per-thread level override for tracing single requests (HOL_LOG_LEVEL_SCOPE)
+ * - Category bitmask filtering within a TAG (TAG_LOG_CAT)
+ * - Cached per-thread context prefix (hol_log_set_context)
+ * - JSON-lines output with precomputed heads and an in-place escaper
  * - Optimized for embedded systems
  * 
  * @section Memory_Usage
- * - Static RAM: 13 bytes/TAG (callback pointer + enable flags)
- * - Stack: ~384 bytes/call (configurable via buffer sizes)
- * - Flash: ~2-4KB/TAG (inline expansion cost)
+ * - Static RAM: ~100 bytes/TAG (hol_log_state_t + typed callback, 32-bit target)
+ * - Stack: ~MAX_LENGTH + 64 bytes/call plus vsnprintf (one formatting pass)
+ * - Flash: ~1KB/TAG (filter check + varargs stubs); formatting core shared by all TAGs
  * 
  * @section Performance
  * - Typical: 50-80 µs/log @ 100MHz ARM Cortex-M
@@ -61,7 +71,7 @@
  * @endcode
  * 
  * @section Optimization_Options
- * - For stack-constrained systems: Set MAX_LENGTH=64, reduce temp buffer
+ * - For stack-constrained systems: Set MAX_LENGTH=64
  * - For flash-constrained systems: Minimize number of TAGs
  * - For RTOS: Wrap calls with mutex
  * - For production: Disable DEBUG level globally
@@ -78,27 +88,1056 @@
 #include <string.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
  * @brief Configurable internal buffer sizes for optimization
- * @note Adjust these based on your system constraints:
+ * @note LOG_INTERNAL_BUFFER caps the formatted message length (text mode) and
+ *       sizes the record buffer of binary mode. Text lines are formatted once,
+ *       straight into the TAG's MAX_LENGTH buffer.
  * 
  * EMBEDDED_STACK_CONSTRAINED:
  *   - LOG_INTERNAL_BUFFER = 64
- *   - Total stack: ~192 bytes/call
+ *   - Messages up to 63 chars, binary record stack: ~64 bytes
  * 
  * EMBEDDED_BALANCED (default):
  *   - LOG_INTERNAL_BUFFER = 128
- *   - Total stack: ~384 bytes/call
+ *   - Messages up to 127 chars, binary record stack: ~128 bytes
  * 
  * DESKTOP/HIGH_MEMORY:
  *   - LOG_INTERNAL_BUFFER = 256
- *   - Total stack: ~768 bytes/call
+ *   - Messages up to 255 chars, binary record stack: ~256 bytes
  */
 #ifndef LOG_INTERNAL_BUFFER
 #define LOG_INTERNAL_BUFFER 128  /* Balanced default for most MCUs */
 #endif
 
+/**
+ * @brief Width of the per-TAG category mask used by TAG_LOG_CAT() (32 or 64)
+ */
+#ifndef LOG_CATEGORY_BITS
+#define LOG_CATEGORY_BITS 32
+#endif
+
+#if LOG_CATEGORY_BITS == 64
+typedef uint64_t hol_log_category_t;
+#elif LOG_CATEGORY_BITS == 32
+typedef uint32_t hol_log_category_t;
+#else
+#error "LOG_CATEGORY_BITS must be 32 or 64"
+#endif
+
+/**
+ * @brief All categories enabled (default mask of every TAG)
+ */
+#define LOG_CATEGORY_ALL ((hol_log_category_t)~(hol_log_category_t)0)
+
+/* ==================== ADAPTIVE LOAD SHEDDING ==================== */
+
+/**
+ * @brief Highest level the load shedder may raise the filter to
+ * @note Equal to TAG_LOG_LEVEL_ERROR: DEBUG, INFO and WARNING can be shed,
+ *       ERROR lines are never dropped by the shedder.
+ */
+#define LOG_SHED_MAX_FLOOR 3
+
+/**
+ * @brief Tick source used to time the sink (e.g. HAL_GetTick, DWT->CYCCNT)
+ * @note Only tick differences are used, so counter wrap-around is harmless.
+ */
+typedef uint32_t (*hol_log_clock_t)(void);
+
+/**
+ * @brief Load shedding controller state (one instance per TAG)
+ *
+ * Pressure samples (sink latency in ticks, queue occupancy, ...) are compared
+ * against two watermarks. `hold` consecutive samples above the high watermark
+ * raise the shed floor by one level (DEBUG, then INFO, then WARNING);
+ * `hold` consecutive samples below the low watermark lower it by one level.
+ * Samples between the watermarks reset both streaks (hysteresis).
+ *
+ * With a clock, shed lines never reach the sink and so produce no samples;
+ * instead, a line shed while the sink has been idle for more than
+ * `high_watermark` ticks counts as one recovery sample.
+ */
+typedef struct {
+    uint32_t high_watermark;                  /* Sample > high: sink is falling behind */
+    uint32_t low_watermark;                   /* Sample < low: sink has recovered */
+    uint8_t  hold;                            /* Samples per step (0 = shedding off) */
+    uint8_t  hot_streak;                      /* Consecutive samples above high */
+    uint8_t  cool_streak;                     /* Consecutive samples below low */
+    uint8_t  floor;                           /* Levels below this are shed */
+    uint32_t raises;                          /* Number of floor increases */
+    uint32_t restores;                        /* Number of floor decreases */
+    uint32_t last_sample;                     /* Clock tick of the last sink sample */
+    uint32_t shed_lines[LOG_SHED_MAX_FLOOR];  /* Lines dropped by shedding, per level */
+} hol_log_shed_t;
+
+/**
+ * @brief Feed one pressure sample into a shedding controller
+ * @param shed   Controller state
+ * @param sample Pressure sample, same unit as the watermarks
+ * @return true if the shed floor changed
+ */
+static inline bool hol_log_shed_feed(hol_log_shed_t* shed, uint32_t sample)
+{
+    if (shed->hold == 0) { return false; }
+
+    if (sample > shed->high_watermark)
+    {
+        shed->cool_streak = 0;
+        if (++shed->hot_streak < shed->hold) { return false; }
+        shed->hot_streak = 0;
+        if (shed->floor >= LOG_SHED_MAX_FLOOR) { return false; }
+        shed->floor++;
+        shed->raises++;
+        return true;
+    }
+
+    if (sample < shed->low_watermark)
+    {
+        shed->hot_streak = 0;
+        if (++shed->cool_streak < shed->hold) { return false; }
+        shed->cool_streak = 0;
+        if (shed->floor == 0) { return false; }
+        shed->floor--;
+        shed->restores++;
+        return true;
+    }
+
+    shed->hot_streak = 0;
+    shed->cool_streak = 0;
+    return false;
+}
+
+/* ==================== BINARY (DEFERRED-FORMAT) MODE ==================== */
+
+/**
+ * @brief Format-string table size per binary stream (power of two)
+ * @note Each entry costs two pointers. A full table falls back to text records.
+ */
+#ifndef LOG_BINARY_TABLE_SIZE
+#define LOG_BINARY_TABLE_SIZE 64
+#endif
+
+/**
+ * @brief Binary stream wire format (all integers little-endian)
+ *
+ * Stream header : 'H' 'O' 'L' 'B' version(u8)
+ * Definition    : 'D' id(u16) tag_len(u8) tag fmt_len(u16) fmt
+ * Log record    : 'L' level(u8, bit7 = truncated) id(u16) payload_len(u16) payload
+ * Text fallback : 'X' level(u8) tag_len(u8) tag text_len(u16) text
+ *
+ * Payload holds one field per conversion of the format string, in order:
+ * - '*' width/precision, d, i : zigzag LEB128 varint
+ * - u, o, x, X, c, p          : LEB128 varint
+ * - e, f, g, a (any case)     : IEEE-754 double, 8 bytes
+ * - s                         : varint length + bytes (no terminator)
+ * - %%, n                     : nothing
+ */
+#define LOG_BINARY_VERSION       1
+#define LOG_BINARY_REC_DEF       'D'
+#define LOG_BINARY_REC_LOG       'L'
+#define LOG_BINARY_REC_TEXT      'X'
+#define LOG_BINARY_TRUNCATED     0x80u
+
+/**
+ * @brief Length modifiers recognised by the format parser
+ */
+typedef enum {
+    HOL_LOG_MOD_NONE = 0,
+    HOL_LOG_MOD_HH,
+    HOL_LOG_MOD_H,
+    HOL_LOG_MOD_L,
+    HOL_LOG_MOD_LL,
+    HOL_LOG_MOD_BIG_L,
+    HOL_LOG_MOD_Z,
+    HOL_LOG_MOD_J,
+    HOL_LOG_MOD_T
+} hol_log_mod_e;
+
+/**
+ * @brief One printf conversion found in a format string
+ */
+typedef struct {
+    const char* start;      /* Points at '%' */
+    uint8_t     length;     /* Characters from '%' to the conversion, inclusive */
+    char        conversion; /* 'd', 's', 'f', '%', ... */
+    uint8_t     modifier;   /* hol_log_mod_e */
+    bool        star_width;
+    bool        star_precision;
+} hol_log_spec_t;
+
+/**
+ * @brief Find the next conversion in a printf format string
+ * @param cursor In: scan position. Out: first character after the conversion.
+ * @param spec   Filled with the conversion found
+ * @return false when the end of the string is reached
+ *
+ * Shared by the binary encoder and the offline decoder (Tools/hol_log_decode.c).
+ */
+static inline bool hol_log_fmt_next(const char** cursor, hol_log_spec_t* spec)
+{
+    const char* p = *cursor;
+    while (*p != '\0' && *p != '%') { p++; }
+    if (*p == '\0') { *cursor = p; return false; }
+
+    spec->start = p++;
+    spec->modifier = HOL_LOG_MOD_NONE;
+    spec->star_width = false;
+    spec->star_precision = false;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'') { p++; }
+    if (*p == '*') { spec->star_width = true; p++; }
+    while (*p >= '0' && *p <= '9') { p++; }
+    if (*p == '.')
+    {
+        p++;
+        if (*p == '*') { spec->star_precision = true; p++; }
+        while (*p >= '0' && *p <= '9') { p++; }
+    }
+
+    switch (*p)
+    {
+        case 'h': p++; spec->modifier = HOL_LOG_MOD_H;
+                  if (*p == 'h') { p++; spec->modifier = HOL_LOG_MOD_HH; } break;
+        case 'l': p++; spec->modifier = HOL_LOG_MOD_L;
+                  if (*p == 'l') { p++; spec->modifier = HOL_LOG_MOD_LL; } break;
+        case 'L': p++; spec->modifier = HOL_LOG_MOD_BIG_L; break;
+        case 'z': p++; spec->modifier = HOL_LOG_MOD_Z; break;
+        case 'j': p++; spec->modifier = HOL_LOG_MOD_J; break;
+        case 't': p++; spec->modifier = HOL_LOG_MOD_T; break;
+        default: break;
+    }
+
+    spec->conversion = *p;
+    if (*p != '\0') { p++; }
+    spec->length = (uint8_t)(p - spec->start);
+    *cursor = p;
+    return spec->conversion != '\0';
+}
+
+/**
+ * @brief Byte sink for binary records (file, DMA ring, socket, ...)
+ * @note Definition records may arrive in several consecutive chunks.
+ */
+typedef void (*hol_log_binary_write_t)(void* ctx, const uint8_t* data, size_t len);
+
+/**
+ * @brief Binary output stream: byte sink plus its format-string table
+ *
+ * Format strings are identified by (tag, format pointer) and numbered the
+ * first time they are logged; the definition record is written once, right
+ * before the first log record that uses it. hol_log_binary_reset() forgets
+ * all IDs, so every new log file carries its own string table.
+ */
+typedef struct {
+    hol_log_binary_write_t write;
+    void*       ctx;
+    const char* fmt_keys[LOG_BINARY_TABLE_SIZE];  /* Slot index is the record ID */
+    const char* tag_keys[LOG_BINARY_TABLE_SIZE];
+    uint32_t    truncated;                        /* Records whose payload did not fit */
+    uint32_t    table_full;                       /* Records sent as text fallback */
+} hol_log_binary_t;
+
+/**
+ * @brief Start a new binary stream (new file): clear the table, write the header
+ */
+static inline void hol_log_binary_reset(hol_log_binary_t* stream)
+{
+    static const uint8_t header[5] = { 'H', 'O', 'L', 'B', LOG_BINARY_VERSION };
+    memset(stream->fmt_keys, 0, sizeof(stream->fmt_keys));
+    memset(stream->tag_keys, 0, sizeof(stream->tag_keys));
+    stream->write(stream->ctx, header, sizeof(header));
+}
+
+/**
+ * @brief Initialise a binary stream and write its header
+ */
+static inline void hol_log_binary_init(hol_log_binary_t* stream, hol_log_binary_write_t write,
+                                       void* ctx)
+{
+    stream->write = write;
+    stream->ctx = ctx;
+    stream->truncated = 0;
+    stream->table_full = 0;
+    hol_log_binary_reset(stream);
+}
+
+/* Encoder helpers: append to a bounded record buffer, return false when out of room */
+static inline bool hol_log_binary_put_varint(uint8_t* buf, size_t cap, size_t* pos, uint64_t v)
+{
+    do
+    {
+        if (*pos >= cap) { return false; }
+        uint8_t byte = (uint8_t)(v & 0x7Fu);
+        v >>= 7;
+        buf[(*pos)++] = (uint8_t)(byte | (v != 0 ? 0x80u : 0u));
+    } while (v != 0);
+    return true;
+}
+
+static inline bool hol_log_binary_put_signed(uint8_t* buf, size_t cap, size_t* pos, int64_t v)
+{
+    uint64_t zigzag = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+    return hol_log_binary_put_varint(buf, cap, pos, zigzag);
+}
+
+/* Look up or assign the ID of (tag, fmt); writes the definition on first use */
+static inline int hol_log_binary_lookup(hol_log_binary_t* stream, const char* tag_str,
+                                        const char* fmt)
+{
+    uintptr_t key = (uintptr_t)fmt ^ ((uintptr_t)tag_str >> 4);
+    size_t slot = (size_t)((key >> 3) ^ (key >> 11)) & (LOG_BINARY_TABLE_SIZE - 1);
+
+    for (size_t probe = 0; probe < LOG_BINARY_TABLE_SIZE; probe++)
+    {
+        if (stream->fmt_keys[slot] == fmt && stream->tag_keys[slot] == tag_str) { return (int)slot; }
+        if (stream->fmt_keys[slot] == NULL)
+        {
+            size_t tag_len = strlen(tag_str);
+            size_t fmt_len = strlen(fmt);
+            if (tag_len > 0xFFu) { tag_len = 0xFFu; }
+            if (fmt_len > 0xFFFFu) { fmt_len = 0xFFFFu; }
+
+            uint8_t head[4] = { LOG_BINARY_REC_DEF, (uint8_t)slot, (uint8_t)(slot >> 8),
+                                (uint8_t)tag_len };
+            uint8_t len16[2] = { (uint8_t)fmt_len, (uint8_t)(fmt_len >> 8) };
+            stream->write(stream->ctx, head, sizeof(head));
+            stream->write(stream->ctx, (const uint8_t*)tag_str, tag_len);
+            stream->write(stream->ctx, len16, sizeof(len16));
+            stream->write(stream->ctx, (const uint8_t*)fmt, fmt_len);
+
+            stream->fmt_keys[slot] = fmt;
+            stream->tag_keys[slot] = tag_str;
+            return (int)slot;
+        }
+        slot = (slot + 1) & (LOG_BINARY_TABLE_SIZE - 1);
+    }
+    return -1;
+}
+
+/**
+ * @brief Encode one log call as a binary record (no text formatting)
+ * @param stream  Destination stream
+ * @param tag_str TAG name (pointer identity is part of the ID key)
+ * @param level   Log level (0..3)
+ * @param fmt     Printf-style format string (pointer identity is the ID key)
+ * @param args    Arguments matching fmt
+ *
+ * @note Stack usage: ~LOG_INTERNAL_BUFFER bytes. A record that does not fit is
+ *       cut at the last whole field and flagged as truncated.
+ */
+static inline void hol_log_binary_vwrite(hol_log_binary_t* stream, const char* tag_str,
+                                         int level, const char* fmt, va_list args)
+{
+    uint8_t record[LOG_INTERNAL_BUFFER];
+    const size_t cap = sizeof(record);
+    size_t pos = 6;   /* 'L' level id(2) payload_len(2) */
+    bool fits = true;
+
+    if (fmt == NULL) { return; }
+    int id = hol_log_binary_lookup(stream, tag_str, fmt);
+    if (id < 0)
+    {
+        /* Table full: format as text so the line is not lost */
+        char text[LOG_INTERNAL_BUFFER];
+        int len = vsnprintf(text, sizeof(text), fmt, args);
+        if (len < 0) { return; }
+        if ((size_t)len >= sizeof(text)) { len = (int)sizeof(text) - 1; }
+        size_t tag_len = strlen(tag_str);
+        if (tag_len > 0xFFu) { tag_len = 0xFFu; }
+        uint8_t head[3] = { LOG_BINARY_REC_TEXT, (uint8_t)level, (uint8_t)tag_len };
+        uint8_t len16[2] = { (uint8_t)len, (uint8_t)((unsigned)len >> 8) };
+        stream->write(stream->ctx, head, sizeof(head));
+        stream->write(stream->ctx, (const uint8_t*)tag_str, tag_len);
+        stream->write(stream->ctx, len16, sizeof(len16));
+        stream->write(stream->ctx, (const uint8_t*)text, (size_t)len);
+        stream->table_full++;
+        return;
+    }
+
+    const char* cursor = fmt;
+    hol_log_spec_t spec;
+    while (fits && hol_log_fmt_next(&cursor, &spec))
+    {
+        size_t mark = pos;
+        if (spec.star_width)     { fits = hol_log_binary_put_signed(record, cap, &pos, va_arg(args, int)); }
+        if (spec.star_precision) { fits = fits && hol_log_binary_put_signed(record, cap, &pos, va_arg(args, int)); }
+
+        switch (spec.conversion)
+        {
+            case 'd': case 'i':
+            {
+                int64_t v;
+                switch (spec.modifier)
+                {
+                    case HOL_LOG_MOD_L:  v = va_arg(args, long); break;
+                    case HOL_LOG_MOD_LL: v = va_arg(args, long long); break;
+                    case HOL_LOG_MOD_J:  v = va_arg(args, intmax_t); break;
+                    case HOL_LOG_MOD_Z:
+                    case HOL_LOG_MOD_T:  v = va_arg(args, ptrdiff_t); break;
+                    default:             v = va_arg(args, int); break;
+                }
+                fits = fits && hol_log_binary_put_signed(record, cap, &pos, v);
+                break;
+            }
+            case 'u': case 'o': case 'x': case 'X':
+            {
+                uint64_t v;
+                switch (spec.modifier)
+                {
+                    case HOL_LOG_MOD_L:  v = va_arg(args, unsigned long); break;
+                    case HOL_LOG_MOD_LL: v = va_arg(args, unsigned long long); break;
+                    case HOL_LOG_MOD_J:  v = va_arg(args, uintmax_t); break;
+                    case HOL_LOG_MOD_Z:  v = va_arg(args, size_t); break;
+                    case HOL_LOG_MOD_T:  v = (uint64_t)va_arg(args, ptrdiff_t); break;
+                    default:             v = va_arg(args, unsigned int); break;
+                }
+                fits = fits && hol_log_binary_put_varint(record, cap, &pos, v);
+                break;
+            }
+            case 'c':
+                fits = fits && hol_log_binary_put_varint(record, cap, &pos,
+                                                         (uint64_t)(unsigned)va_arg(args, int));
+                break;
+            case 'p':
+                fits = fits && hol_log_binary_put_varint(record, cap, &pos,
+                                                         (uint64_t)(uintptr_t)va_arg(args, void*));
+                break;
+            case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+            {
+                double v = (spec.modifier == HOL_LOG_MOD_BIG_L) ? (double)va_arg(args, long double)
+                                                                 : va_arg(args, double);
+                if (fits && pos + sizeof(v) <= cap)
+                {
+                    memcpy(&record[pos], &v, sizeof(v));   /* Host order: LE on all supported targets */
+                    pos += sizeof(v);
+                }
+                else
+                {
+                    fits = false;
+                }
+                break;
+            }
+            case 's':
+            {
+                const char* str = va_arg(args, const char*);
+                if (str == NULL) { str = "(null)"; }
+                size_t len = strlen(str);
+                /* Strings are the only field cut short rather than dropped */
+                if (fits && pos + 3 < cap)
+                {
+                    size_t room = cap - pos - 3;   /* Worst-case varint length prefix */
+                    if (len > room) { len = room; fits = false; }
+                    (void)hol_log_binary_put_varint(record, cap, &pos, len);
+                    memcpy(&record[pos], str, len);
+                    pos += len;
+                    mark = pos;
+                }
+                else
+                {
+                    fits = false;
+                }
+                break;
+            }
+            case 'n':
+                (void)va_arg(args, void*);
+                break;
+            default:   /* '%%' and unknown conversions carry no argument */
+                break;
+        }
+        if (!fits) { pos = mark; }
+    }
+
+    size_t payload = pos - 6;
+    uint8_t flags = fits ? 0u : LOG_BINARY_TRUNCATED;
+    record[0] = LOG_BINARY_REC_LOG;
+    record[1] = (uint8_t)((unsigned)level | flags);
+    record[2] = (uint8_t)id;
+    record[3] = (uint8_t)((unsigned)id >> 8);
+    record[4] = (uint8_t)payload;
+    record[5] = (uint8_t)(payload >> 8);
+    if (!fits) { stream->truncated++; }
+    stream->write(stream->ctx, record, pos);
+}
+
+/* ==================== THREAD-LOCAL LEVEL OVERRIDE ==================== */
+
+/**
+ * @brief Storage class for per-thread logger state
+ * @note Defaults to C11 _Thread_local, GCC/Clang __thread in C99 mode, and plain
+ *       static storage elsewhere (single-threaded targets). Define it before
+ *       including this header to use a compiler-specific keyword.
+ */
+#ifndef HOL_LOG_THREAD_LOCAL
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define HOL_LOG_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define HOL_LOG_THREAD_LOCAL __thread
+#else
+#define HOL_LOG_THREAD_LOCAL
+#endif
+#endif
+
+/**
+ * @brief Run a block with a thread-local level override for one TAG
+ * @param TAG   Logger TAG
+ * @param level Lowest level to emit on this thread inside the block
+ *
+ * The previous override is restored when the block ends, so scopes nest.
+ * The macro is a one-pass for loop: break or continue inside the block ends
+ * the scope itself, not an enclosing loop. With GCC/Clang the override is
+ * also restored on return or goto out of the block (cleanup attribute). With
+ * other compilers the block must be left normally: a return, goto or
+ * longjmp out of it keeps the override.
+ *
+ * @code
+ * HOL_LOG_LEVEL_SCOPE(APP, APP_LOG_LEVEL_DEBUG)
+ * {
+ *     handle_request(req);   // APP_LOG_DEBUG lines from this thread only
+ * }
+ * @endcode
+ */
+#if defined(__GNUC__)
+#define HOL_LOG_LEVEL_SCOPE(TAG, level)                                                        \
+    for (int hol_log_saved_ __attribute__((cleanup(TAG##_log_thread_restore)))                 \
+             = (int)TAG##_set_thread_level(level), hol_log_once_ = 1;                          \
+         hol_log_once_; hol_log_once_ = 0)
+#else
+#define HOL_LOG_LEVEL_SCOPE(TAG, level)                                                        \
+    for (int hol_log_saved_ = (int)TAG##_set_thread_level(level); hol_log_saved_ >= 0;         \
+         TAG##_log_thread_restore(&hol_log_saved_), hol_log_saved_ = -1)
+#endif
+
+/* ==================== LINE SINKS ==================== */
+
+/**
+ * @brief Level-aware output sink (alternative to the plain callback)
+ * @param ctx   User context given to TAG_set_line_sink()
+ * @param level Log level of the line (0 = DEBUG ... 3 = ERROR)
+ * @param line  Formatted, NUL-terminated line including CRLF
+ * @param len   strlen(line), so sinks never have to scan the line
+ *
+ * Used by sinks that need more than the text, e.g. the file sink in
+ * HOL_LogFile.h (per-level line counts, byte offsets).
+ */
+typedef void (*hol_log_line_sink_t)(void* ctx, int level, const char* line, size_t len);
+
+/* ==================== USDT TRACEPOINTS ==================== */
+
+/**
+ * @brief Set to 1 to compile static tracepoints for bpftrace / perf / SystemTap
+ * @note Needs <sys/sdt.h> (systemtap-sdt-dev / systemtap-sdt-devel). Each
+ *       probe is a single NOP until a tracer attaches.
+ *
+ * Probes (provider hol_log):
+ *   emit (tag, level, line, len) : line formatted (binary mode: line NULL, len 0)
+ *   shed (tag, level)            : line dropped by load shedding
+ *
+ * bpftrace -e 'usdt:./app:hol_log:emit /arg1 == 3/ { printf("%s", str(arg2, arg3)); }'
+ */
+#ifndef HOL_ENABLE_USDT
+#define HOL_ENABLE_USDT 0
+#endif
+
+#if HOL_ENABLE_USDT
+#include <sys/sdt.h>
+#define LOG_PROBE_EMIT(tag, level, line, len) DTRACE_PROBE4(hol_log, emit, tag, level, line, len)
+#define LOG_PROBE_SHED(tag, level)            DTRACE_PROBE2(hol_log, shed, tag, level)
+#else
+#define LOG_PROBE_EMIT(tag, level, line, len) ((void)0)
+#define LOG_PROBE_SHED(tag, level)            ((void)0)
+#endif
+
+/* ==================== SHARED LOGGING CORE ==================== */
+
+/**
+ * @brief Linkage of the shared (non-TAG) logging core
+ * @note GCC/Clang: weak and out of line, so every translation unit calls the
+ *       same copy; build with -ffunction-sections -Wl,--gc-sections to drop
+ *       the unreferenced duplicates. Other compilers get static inline: one
+ *       copy per translation unit, still not one per TAG. Define before
+ *       including this header to override.
+ */
+#ifndef HOL_LOG_CORE
+#if defined(__GNUC__)
+#define HOL_LOG_CORE __attribute__((weak, noinline))
+#else
+#define HOL_LOG_CORE static inline
+#endif
+#endif
+
+/**
+ * @brief Core symbol names carry the layout-affecting configuration
+ * @note The weak core is only shared between translation units built with the
+ *       same LOG_CATEGORY_BITS, LOG_CONTEXT_SIZE, LOG_INTERNAL_BUFFER,
+ *       LOG_BINARY_TABLE_SIZE and HOL_ENABLE_USDT. A unit with other values
+ *       links against its own copy (e.g. hol_log_vwrite_c32_x48_b128_t64_u0)
+ *       instead of a mismatched one. These macros must therefore be plain
+ *       decimal literals.
+ */
+#define HOL_LOG_CORE_CAT_(n, c, x, b, t, u) n##_c##c##_x##x##_b##b##_t##t##_u##u
+#define HOL_LOG_CORE_CAT(n, c, x, b, t, u)  HOL_LOG_CORE_CAT_(n, c, x, b, t, u)
+#define HOL_LOG_CORE_NAME(name)                                                                \
+    HOL_LOG_CORE_CAT(name, LOG_CATEGORY_BITS, LOG_CONTEXT_SIZE, LOG_INTERNAL_BUFFER,           \
+                     LOG_BINARY_TABLE_SIZE, HOL_ENABLE_USDT)
+
+#define hol_log_context     HOL_LOG_CORE_NAME(hol_log_context)
+#define hol_log_json_escape HOL_LOG_CORE_NAME(hol_log_json_escape)
+#define hol_log_emit        HOL_LOG_CORE_NAME(hol_log_emit)
+#define hol_log_json_vwrite HOL_LOG_CORE_NAME(hol_log_json_vwrite)
+#define hol_log_vwrite      HOL_LOG_CORE_NAME(hol_log_vwrite)
+
+/**
+ * @brief Precomputed JSON line head for one TAG and level
+ * @note Built at compile time by TAG_set_json_output(), e.g.
+ *       {"level":"INFO","tag":"APP"
+ */
+typedef struct {
+    const char* text;
+    uint8_t     len;
+} hol_log_json_head_t;
+
+#define HOL_LOG_JSON_HEAD_LITERAL(level, tag) "{\"level\":\"" level "\",\"tag\":\"" tag "\""
+#define HOL_LOG_JSON_HEAD(level, tag)                                                          \
+    { HOL_LOG_JSON_HEAD_LITERAL(level, tag), (uint8_t)(sizeof(HOL_LOG_JSON_HEAD_LITERAL(level, tag)) - 1) }
+
+/**
+ * @brief Per-TAG logger state, handed to the shared core by pointer
+ * @note Only the filter check and a varargs stub are generated per TAG;
+ *       formatting, binary encoding and dispatch run in the shared core.
+ */
+typedef struct {
+    const char*          tag;                /* TAG name */
+    uint8_t              tag_len;            /* strlen(tag) */
+    bool                 enabled;            /* Global enable/disable flag */
+    uint8_t              min_level;          /* User level filter */
+    uint8_t              threshold;          /* max(min_level, shed.floor) */
+    hol_log_category_t   category_mask;      /* TAG_LOG_CAT filter */
+    void               (*callback)(const char* line);  /* Typed callback adapter */
+    hol_log_line_sink_t  line_sink;          /* Level-aware sink (optional) */
+    void*                line_sink_ctx;
+    bool               (*defer)(int level, const char* line, size_t len);  /* Deferred hook */
+    void               (*recent)(int level, const char* line, size_t len); /* Recent-records tap */
+    hol_log_binary_t*    binary;             /* Binary stream (NULL = text) */
+    const hol_log_json_head_t* json;         /* JSON heads per level (NULL = text) */
+    hol_log_clock_t      clock;              /* Sink timing source (optional) */
+    hol_log_shed_t       shed;               /* Load shedding controller */
+    uint32_t             lines[4];           /* Lines/records produced per level */
+    uint32_t             truncated;          /* Messages cut to fit the line */
+} hol_log_state_t;
+
+/**
+ * @brief Bump a per-TAG statistics counter
+ * @note Relaxed atomic with GCC/Clang: DECLARE_LOG_DEFERRED_PERCPU formats on
+ *       many threads at once. Plain increment elsewhere (single-core targets).
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define HOL_LOG_COUNT(counter) (void)__atomic_fetch_add(&(counter), 1u, __ATOMIC_RELAXED)
+#else
+#define HOL_LOG_COUNT(counter) ((counter)++)
+#endif
+
+/* Recompute the effective threshold after a filter or shed floor change */
+static inline void hol_log_state_refresh(hol_log_state_t* state)
+{
+    state->threshold = (state->min_level > state->shed.floor) ? state->min_level
+                                                              : state->shed.floor;
+}
+
+/* Reject path of a shed line: an idle sink counts as a recovery sample (clock mode) */
+static inline void hol_log_shed_idle(hol_log_state_t* state)
+{
+    if (state->clock == NULL) { return; }
+    uint32_t now = state->clock();
+    uint32_t last = state->shed.last_sample;
+    if (now - last <= state->shed.high_watermark) { return; }
+#if defined(__GNUC__) || defined(__clang__)
+    /* Per-CPU deferred mode rejects on many threads: one of them feeds the sample */
+    if (!__atomic_compare_exchange_n(&state->shed.last_sample, &last, now, false,
+                                     __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+#else
+    state->shed.last_sample = now;
+#endif
+    if (hol_log_shed_feed(&state->shed, 0u)) { hol_log_state_refresh(state); }
+}
+
+/**
+ * @brief Capacity of the per-thread context prefix (thread name, request id)
+ */
+#ifndef LOG_CONTEXT_SIZE
+#define LOG_CONTEXT_SIZE 48
+#endif
+
+#if LOG_CONTEXT_SIZE > 255
+#error "LOG_CONTEXT_SIZE must be at most 255"
+#endif
+
+/**
+ * @brief Per-thread context, rendered once by hol_log_set_context()
+ */
+typedef struct {
+    uint8_t  len;                          /* 0 = no context */
+    char     text[LOG_CONTEXT_SIZE];       /* e.g. "[worker-3/8f2a1c] " */
+    uint16_t json_len;                     /* Same context, pre-escaped JSON fields */
+    char     json[2 * LOG_CONTEXT_SIZE];   /* e.g. ,"thread":"worker-3","request":"8f2a1c" */
+} hol_log_context_t;
+
+/**
+ * @brief JSON escape table for ASCII: 0 = copy as is, 'u' = \u00XX, else '\\' + entry
+ */
+static const char hol_log_json_escapes[128] =
+{
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    ['"'] = '"',
+    ['\\'] = '\\',
+};
+
+HOL_LOG_CORE hol_log_context_t* hol_log_context(void);
+HOL_LOG_CORE size_t hol_log_json_escape(char* text, size_t len, size_t cap);
+
+/* Length of text[0..len) without a trailing incomplete UTF-8 sequence */
+static inline size_t hol_log_utf8_trim(const char* text, size_t len)
+{
+    size_t i = len;
+    while (i > 0 && len - i < 3u && ((unsigned char)text[i - 1] & 0xC0u) == 0x80u) { i--; }
+    if (i == 0) { return len; }
+
+    unsigned char lead = (unsigned char)text[i - 1];
+    size_t need = (lead >= 0xF0u) ? 4u : (lead >= 0xE0u) ? 3u : (lead >= 0xC0u) ? 2u : 1u;
+    return (len - i + 1u < need) ? i - 1u : len;
+}
+HOL_LOG_CORE void hol_log_emit(hol_log_state_t* state, int level, const char* line, size_t len);
+HOL_LOG_CORE void hol_log_json_vwrite(hol_log_state_t* state, int level, char* buffer, size_t size,
+                                      const char* fmt, va_list args);
+HOL_LOG_CORE void hol_log_vwrite(hol_log_state_t* state, int level, char* buffer, size_t size,
+                                 const char* fmt, va_list args);
+
+/* Hand a finished line to the recent-records tap, then the deferred lanes or the output */
+static inline void hol_log_dispatch(hol_log_state_t* state, int level, const char* line, size_t len)
+{
+    if ((unsigned)level < 4u) { HOL_LOG_COUNT(state->lines[level]); }
+    LOG_PROBE_EMIT(state->tag, level, line, len);
+    if (state->recent != NULL) { state->recent(level, line, len); }
+
+    /* Deferred mode: queue the line for TAG_log_flush() */
+    if (state->defer != NULL)
+    {
+        (void)state->defer(level, line, len);
+        return;
+    }
+    hol_log_emit(state, level, line, len);
+}
+
+/**
+ * @brief Calling thread's context slot (one per thread, shared by all TAGs)
+ */
+HOL_LOG_CORE hol_log_context_t* hol_log_context(void)
+{
+    static HOL_LOG_THREAD_LOCAL hol_log_context_t context;
+    return &context;
+}
+
+/**
+ * @brief Escape text[0..len) for a JSON string, in place
+ * @param text Raw text; the buffer must hold cap bytes
+ * @param len  Raw length
+ * @param cap  Maximum escaped length
+ * @return Escaped length (<= cap). Input that does not fit is cut at a
+ *         character boundary (never inside an escape or a UTF-8 sequence).
+ *
+ * Runs that need no escaping are skipped 8 bytes at a time; text without
+ * special characters (the common case) is left untouched. Otherwise the
+ * output is measured, then expanded back to front, so no second buffer is
+ * needed.
+ */
+HOL_LOG_CORE size_t hol_log_json_escape(char* text, size_t len, size_t cap)
+{
+    const uint64_t ones = 0x0101010101010101u;
+    const uint64_t highs = 0x8080808080808080u;
+    size_t limit = (len < cap) ? len : cap;
+    size_t n = 0;
+
+    /* Fast scan: no byte < 0x20, '"' or '\\' in the next 8 bytes */
+    while (n + 8u <= limit)
+    {
+        uint64_t v;
+        memcpy(&v, &text[n], sizeof(v));
+        uint64_t quote = v ^ (ones * '"');
+        uint64_t slash = v ^ (ones * '\\');
+        uint64_t special = (((v - ones * 0x20u) & ~v) | ((quote - ones) & ~quote) |
+                            ((slash - ones) & ~slash)) & highs;
+        if (special != 0) { break; }
+        n += 8u;
+    }
+    while (n < limit && ((unsigned char)text[n] >= 128u || hol_log_json_escapes[(unsigned char)text[n]] == 0))
+    {
+        n++;
+    }
+    if (n == len) { return len; }   /* Nothing to escape and it fits */
+
+    size_t first = n;               /* text[0..first) stays in place */
+    size_t out = n;
+    for (; n < len; n++)
+    {
+        unsigned char c = (unsigned char)text[n];
+        char e = (c < 128u) ? hol_log_json_escapes[c] : 0;
+        size_t width = (e == 0) ? 1u : ((e == 'u') ? 6u : 2u);
+        if (out + width > cap) { break; }
+        out += width;
+    }
+
+    /* Cut inside a UTF-8 sequence: drop its leading bytes too (each 1 byte wide) */
+    if (n < len)
+    {
+        size_t kept = hol_log_utf8_trim(text, n);
+        out -= n - kept;
+        n = kept;
+    }
+
+    if (out == n) { return n; }   /* Nothing to escape */
+
+    size_t o = out;
+    while (n > first)
+    {
+        unsigned char c = (unsigned char)text[--n];
+        char e = (c < 128u) ? hol_log_json_escapes[c] : 0;
+        if (e == 0)
+        {
+            text[--o] = (char)c;
+        }
+        else if (e == 'u')
+        {
+            o -= 6;
+            memcpy(&text[o], "\\u00", 4);
+            text[o + 4] = "0123456789abcdef"[c >> 4];
+            text[o + 5] = "0123456789abcdef"[c & 0x0Fu];
+        }
+        else
+        {
+            text[--o] = e;
+            text[--o] = '\\';
+        }
+    }
+    return out;
+}
+
+/* Append ,"key":"escaped value" to a context JSON buffer */
+static inline size_t hol_log_json_put_field(char* dst, size_t pos, size_t cap,
+                                            const char* key, const char* value)
+{
+    size_t key_len = strlen(key);
+    if (value == NULL || pos + key_len + 1u > cap) { return pos; }
+    memcpy(&dst[pos], key, key_len);
+    pos += key_len;
+
+    size_t room = cap - pos - 1u;   /* Keep the closing quote */
+    size_t len = strlen(value);
+    if (len > room) { len = room; }
+    memcpy(&dst[pos], value, len);
+    pos += hol_log_json_escape(&dst[pos], len, room);
+    dst[pos++] = '"';
+    return pos;
+}
+
+/**
+ * @brief Set the context printed after "[L] (TAG): " on this thread's lines
+ * @param thread_name Thread name, or NULL
+ * @param request_id  Request/correlation id, or NULL
+ *
+ * The prefix is rendered here, once, so each log line only copies it.
+ * Passing NULL for both clears the context. Text mode only: binary records
+ * do not carry it.
+ *
+ * @code
+ * hol_log_set_context("worker-3", req->id);
+ * APP_LOG_INFO("Parsed %u headers", n);   // [I] (APP): [worker-3/8f2a1c] Parsed 12 headers
+ * hol_log_set_context("worker-3", NULL);
+ * @endcode
+ */
+static inline void hol_log_set_context(const char* thread_name, const char* request_id)
+{
+    hol_log_context_t* context = hol_log_context();
+    int len;
+
+    if (thread_name != NULL && request_id != NULL)
+    {
+        len = snprintf(context->text, sizeof(context->text), "[%s/%s] ", thread_name, request_id);
+    }
+    else if (thread_name != NULL || request_id != NULL)
+    {
+        len = snprintf(context->text, sizeof(context->text), "[%s] ",
+                       (thread_name != NULL) ? thread_name : request_id);
+    }
+    else
+    {
+        len = 0;
+    }
+
+    if (len < 0) { len = 0; }
+    if ((size_t)len >= sizeof(context->text))
+    {
+        /* Truncated: keep the closing bracket */
+        len = (int)sizeof(context->text) - 1;
+        memcpy(&context->text[len - 2], "] ", 2);
+    }
+    context->len = (uint8_t)len;
+
+    /* JSON output mode: the same context as pre-escaped fields */
+    size_t pos = hol_log_json_put_field(context->json, 0, sizeof(context->json),
+                                        ",\"thread\":\"", thread_name);
+    context->json_len = (uint16_t)hol_log_json_put_field(context->json, pos, sizeof(context->json),
+                                                         ",\"request\":\"", request_id);
+}
+
+/**
+ * @brief Deliver a finished line to the line sink or callback
+ * @note Times the sink and feeds the load shedder when a clock is configured.
+ */
+HOL_LOG_CORE void hol_log_emit(hol_log_state_t* state, int level, const char* line, size_t len)
+{
+    uint32_t start = (state->clock != NULL) ? state->clock() : 0;
+
+    if (state->line_sink != NULL)
+    {
+        state->line_sink(state->line_sink_ctx, level, line, len);
+    }
+    else if (state->callback != NULL)
+    {
+        state->callback(line);
+    }
+
+    if (state->clock != NULL)
+    {
+        uint32_t end = state->clock();
+        state->shed.last_sample = end;
+        if (hol_log_shed_feed(&state->shed, end - start)) { hol_log_state_refresh(state); }
+    }
+}
+
+/**
+ * @brief Format {"level":..,"tag":..,[context,]"msg":".."}\n and dispatch it
+ * @note Same single formatting pass as text mode: the head and context are
+ *       copied, the message is formatted in place and escaped in place.
+ */
+HOL_LOG_CORE void hol_log_json_vwrite(hol_log_state_t* state, int level, char* buffer, size_t size,
+                                      const char* fmt, va_list args)
+{
+    static const char msg_key[] = ",\"msg\":\"";
+    const hol_log_json_head_t* head = &state->json[level];
+    size_t offset = head->len;
+
+    /* Head + msg key + "}\n and NUL must fit */
+    if (offset + (sizeof(msg_key) - 1u) + 4u >= size) { return; }
+    memcpy(buffer, head->text, head->len);
+
+    const hol_log_context_t* context = hol_log_context();
+    if (context->json_len != 0 && offset + context->json_len + (sizeof(msg_key) - 1u) + 4u < size)
+    {
+        memcpy(&buffer[offset], context->json, context->json_len);
+        offset += context->json_len;
+    }
+    memcpy(&buffer[offset], msg_key, sizeof(msg_key) - 1u);
+    offset += sizeof(msg_key) - 1u;
+
+    /* Format the message in place, then escape it in place */
+    size_t cap = size - offset - 4u;
+    size_t room = cap + 1u;
+    if (room > LOG_INTERNAL_BUFFER) { room = LOG_INTERNAL_BUFFER; }
+    int result = vsnprintf(&buffer[offset], room, fmt, args);
+    if (result <= 0) { return; }   /* Format error or empty message */
+    size_t len = (size_t)result;
+    if (len >= room)
+    {
+        len = hol_log_utf8_trim(&buffer[offset], room - 1u);
+        HOL_LOG_COUNT(state->truncated);
+    }
+    offset += hol_log_json_escape(&buffer[offset], len, cap);
+
+    memcpy(&buffer[offset], "\"}\n", 3);
+    offset += 3;
+    buffer[offset] = '\0';
+
+    hol_log_dispatch(state, level, buffer, offset);
+}
+
+/**
+ * @brief Format "[L] (TAG): [context] message\r\n" and dispatch it (shared by all TAGs)
+ * @param state  TAG state
+ * @param level  Log level (already filtered by the caller)
+ * @param buffer Caller's line buffer (MAX_LENGTH bytes, on the caller's stack)
+ * @param size   sizeof(buffer)
+ * @param fmt    Printf-style format string
+ * @param args   Format arguments
+ *
+ * The message is formatted once, directly after the prefix, and capped at
+ * LOG_INTERNAL_BUFFER - 1 characters. Over-long lines are cut so the CRLF
+ * always fits. Empty messages are not logged.
+ */
+HOL_LOG_CORE void hol_log_vwrite(hol_log_state_t* state, int level, char* buffer, size_t size,
+                                 const char* fmt, va_list args)
+{
+    if (fmt == NULL) { return; }
+
+    if (state->binary != NULL)
+    {
+        hol_log_binary_vwrite(state->binary, state->tag, level, fmt, args);
+        if ((unsigned)level < 4u) { HOL_LOG_COUNT(state->lines[level]); }
+        LOG_PROBE_EMIT(state->tag, level, (const char*)NULL, (size_t)0);
+        return;
+    }
+
+    /* Early exit if no output registered */
+    if (state->callback == NULL && state->line_sink == NULL && state->recent == NULL)
+    {
+        return;
+    }
+
+    if (state->json != NULL && (unsigned)level < 4u)
+    {
+        hol_log_json_vwrite(state, level, buffer, size, fmt, args);
+        return;
+    }
+
+    /* Build prefix: [LEVEL] (TAG): */
+    size_t offset = 8u + state->tag_len;
+    if (offset + 3u > size) { return; }   /* Buffer too small - abort safely */
+    buffer[0] = '[';
+    buffer[1] = ((unsigned)level < 4u) ? "DIWE"[level] : '?';
+    memcpy(&buffer[2], "] (", 3);
+    memcpy(&buffer[5], state->tag, state->tag_len);
+    memcpy(&buffer[5 + state->tag_len], "): ", 3);
+
+    /* Thread context: pre-rendered, so a single copy */
+    const hol_log_context_t* context = hol_log_context();
+    if (context->len != 0 && offset + context->len + 3u <= size)
+    {
+        memcpy(&buffer[offset], context->text, context->len);
+        offset += context->len;
+    }
+
+    /* Append user message with format arguments */
+    size_t room = size - offset;
+    if (room > LOG_INTERNAL_BUFFER) { room = LOG_INTERNAL_BUFFER; }
+    int result = vsnprintf(&buffer[offset], room, fmt, args);
+    if (result <= 0) { return; }   /* Format error or empty message */
+    offset += ((size_t)result < room) ? (size_t)result : room - 1;
+
+    /* Append CRLF line ending, truncating the message if needed */
+    if ((size_t)result >= room || offset > size - 3u) { HOL_LOG_COUNT(state->truncated); }
+    if (offset > size - 3u) { offset = size - 3u; }
+    buffer[offset++] = '\r';
+    buffer[offset++] = '\n';
+    buffer[offset] = '\0';
+
+    hol_log_dispatch(state, level, buffer, offset);
+}
+
 /**
  * @brief Main logger macro declaration
  * 
@@ -111,17 +1150,30 @@
  * 
  * @note Generated functions:
  *   - TAG_set_callback(handler)           : Register output callback
+ *   - TAG_set_line_sink(sink, ctx)        : Register level-aware sink (overrides callback)
  *   - TAG_log_enable()                        : Enable all log levels
  *   - TAG_log_disable()                       : Disable all log levels
  *   - TAG_is_enabled()                    : Check if logger is enabled
  *   - TAG_set_level_filter(min_level)     : Set minimum log level
  *   - TAG_get_level_filter()              : Get current minimum level
+ *   - TAG_get_effective_level()           : Get level after load shedding
+ *   - TAG_set_thread_level(level)         : Per-thread override, returns previous
+ *   - TAG_get_thread_level()              : Current thread's override (NONE = off)
+ *   - TAG_set_shed_policy(clk, hi, lo, n) : Configure adaptive load shedding
+ *   - TAG_log_shed_feed(sample)           : Feed an external pressure sample
+ *   - TAG_get_shed_stats()                : Read shedding counters
+ *   - TAG_set_binary_stream(stream)       : Switch to binary output (NULL = text)
+ *   - TAG_set_json_output(enable)         : JSON-lines instead of plain text
+ *   - TAG_set_category_mask(mask)         : Enabled categories for TAG_LOG_CAT
+ *   - TAG_get_category_mask()             : Current category mask
+ *   - TAG_log_write(level, tag, fmt, ...) : Log at a runtime level (tag ignored)
  *   - TAG_LOG_DEBUG(fmt, ...)             : Debug level logging
  *   - TAG_LOG_INFO(fmt, ...)              : Info level logging
  *   - TAG_LOG_WARNING(fmt, ...)           : Warning level logging
  *   - TAG_LOG_ERROR(fmt, ...)             : Error level logging
+ *   - TAG_LOG_CAT(cat, level, fmt, ...)   : Logging filtered by category and level
  * 
- * @warning Each TAG adds ~2-4KB to flash due to inline expansion
+ * @warning Each TAG adds ~1KB to flash (x86-64 -Os; varargs stubs are smaller on Cortex-M)
  */
 #define DECLARE_LOG(TAG, MAX_LENGTH, RETTYPE)                                                  \
                                                                                                \
@@ -140,8 +1192,39 @@ typedef enum
                                                                                                \
 /* Static state variables - isolated per TAG */                                                \
 static TAG##_log_ready_callback_t TAG##_log_handler = NULL;                                    \
-static bool TAG##_log_enabled = true;                  /* Global enable/disable flag */        \
-static TAG##_log_level_e TAG##_log_min_level = TAG##_LOG_LEVEL_DEBUG;  /* Minimum level */     \
+static hol_log_state_t TAG##_log_state =                                                       \
+{                                                                                              \
+    .tag = #TAG,                                                                               \
+    .tag_len = (uint8_t)(sizeof(#TAG) - 1),                                                    \
+    .enabled = true,                                                                           \
+    .min_level = TAG##_LOG_LEVEL_DEBUG,                                                        \
+    .threshold = TAG##_LOG_LEVEL_DEBUG,                                                        \
+    .category_mask = LOG_CATEGORY_ALL,                                                         \
+};                                                                                             \
+/* Per-thread override: levels >= this pass regardless of filter/shedding (NONE = off) */      \
+static HOL_LOG_THREAD_LOCAL TAG##_log_level_e TAG##_log_thread_level = TAG##_LOG_LEVEL_NONE;   \
+                                                                                               \
+/* Adapter from the shared core to the typed callback */                                       \
+static inline void TAG##_log_call_handler(const char* line)                                    \
+{                                                                                              \
+    (void)TAG##_log_handler(line);                                                             \
+}                                                                                              \
+                                                                                               \
+/* Fast-path filter shared by all logging entry points; counts shed lines */                   \
+static inline bool TAG##_log_should_emit(TAG##_log_level_e level)                              \
+{                                                                                              \
+    if (!TAG##_log_state.enabled) { return false; }                                            \
+    if ((unsigned)level >= TAG##_log_state.threshold) { return true; }                         \
+    if (level >= TAG##_log_thread_level) { return true; }    /* Thread override */             \
+    /* Rejected: it was shed if the user filter alone would have let it through */             \
+    if ((unsigned)level < LOG_SHED_MAX_FLOOR && (unsigned)level >= TAG##_log_state.min_level)  \
+    {                                                                                          \
+        HOL_LOG_COUNT(TAG##_log_state.shed.shed_lines[level]);                                 \
+        LOG_PROBE_SHED(TAG##_log_state.tag, (int)level);                                       \
+        hol_log_shed_idle(&TAG##_log_state);                                                   \
+    }                                                                                          \
+    return false;                                                                              \
+}                                                                                              \
                                                                                                \
 /**                                                                                            \
  * @brief Register callback function for log output                                            \
@@ -158,6 +1241,31 @@ static TAG##_log_level_e TAG##_log_min_level = TAG##_LOG_LEVEL_DEBUG;  /* Minimu
 static inline void TAG##_set_callback(TAG##_log_ready_callback_t handler)                      \
 {                                                                                              \
     TAG##_log_handler = handler;                                                               \
+    TAG##_log_state.callback = (handler != NULL) ? TAG##_log_call_handler : NULL;              \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Register a level-aware sink; takes precedence over the callback                      \
+ * @param sink Function receiving (ctx, level, line, length), NULL to use the callback again   \
+ * @param ctx  Opaque pointer passed back to the sink                                          \
+ *                                                                                             \
+ * Example:                                                                                    \
+ * @code                                                                                       \
+ * hol_log_file_t log_file;                                                                    \
+ * hol_log_file_open(&log_file, "app.log", "app.log.idx", 64 * 1024, 1000);                    \
+ * APP_set_line_sink(hol_log_file_line_sink, &log_file);                                       \
+ * @endcode                                                                                    \
+ */                                                                                            \
+static inline void TAG##_set_line_sink(hol_log_line_sink_t sink, void* ctx)                    \
+{                                                                                              \
+    TAG##_log_state.line_sink_ctx = ctx;                                                       \
+    TAG##_log_state.line_sink = sink;                                                          \
+}                                                                                              \
+                                                                                               \
+/* True when a callback or line sink is registered */                                          \
+static inline bool TAG##_log_has_output(void)                                                  \
+{                                                                                              \
+    return TAG##_log_state.callback != NULL || TAG##_log_state.line_sink != NULL;              \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -174,7 +1282,7 @@ static inline void TAG##_set_callback(TAG##_log_ready_callback_t handler)
  */                                                                                            \
 static inline void TAG##_log_enable(void)                                                      \
 {                                                                                              \
-    TAG##_log_enabled = true;                                                                  \
+    TAG##_log_state.enabled = true;                                                            \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -193,7 +1301,7 @@ static inline void TAG##_log_enable(void)
  */                                                                                            \
 static inline void TAG##_log_disable(void)                                                     \
 {                                                                                              \
-    TAG##_log_enabled = false;                                                                 \
+    TAG##_log_state.enabled = false;                                                           \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -210,7 +1318,7 @@ static inline void TAG##_log_disable(void)
  */                                                                                            \
 static inline bool TAG##_log_is_enabled(void)                                                  \
 {                                                                                              \
-    return TAG##_log_enabled;                                                                  \
+    return TAG##_log_state.enabled;                                                            \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -233,7 +1341,8 @@ static inline bool TAG##_log_is_enabled(void)
  */                                                                                            \
 static inline void TAG##_set_level_filter(TAG##_log_level_e min_level)                         \
 {                                                                                              \
-    TAG##_log_min_level = min_level;                                                           \
+    TAG##_log_state.min_level = (uint8_t)min_level;                                            \
+    hol_log_state_refresh(&TAG##_log_state);                                                   \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -250,89 +1359,187 @@ static inline void TAG##_set_level_filter(TAG##_log_level_e min_level)
  */                                                                                            \
 static inline TAG##_log_level_e TAG##_get_level_filter(void)                                   \
 {                                                                                              \
-    return TAG##_log_min_level;                                                                \
+    return (TAG##_log_level_e)TAG##_log_state.min_level;                                       \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
- * @brief Core logging function (internal use)                                                 \
- * @param level    Log severity level                                                          \
- * @param tag_str  TAG name as string                                                          \
- * @param fmt      Printf-style format string                                                  \
- * @param ...      Variadic arguments                                                          \
+ * @brief Get the level actually applied (user filter raised by load shedding)                 \
+ * @return max(TAG_get_level_filter(), current shed floor)                                     \
+ */                                                                                            \
+static inline TAG##_log_level_e TAG##_get_effective_level(void)                                \
+{                                                                                              \
+    return (TAG##_log_level_e)TAG##_log_state.threshold;                                       \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Override the level filter for the calling thread only                                \
+ * @param level Lowest level to emit on this thread (TAG_LOG_LEVEL_NONE = no override)         \
+ * @return Previous override, to restore later                                                 \
+ *                                                                                             \
+ * Lets one request be traced at DEBUG while every other thread stays at the TAG's             \
+ * filter. The override only widens output; it bypasses the filter and load shedding           \
+ * but not TAG_log_disable(). Lines above the filter pay no extra cost; filtered lines         \
+ * pay one thread-local load. Prefer HOL_LOG_LEVEL_SCOPE() for scoped use.                     \
  *                                                                                             \
- * @note Stack usage: ~(MAX_LENGTH + LOG_INTERNAL_BUFFER) bytes                                \
- * @warning NOT reentrant - do not call from ISR!                                              \
- * @warning NOT thread-safe - protect with mutex in RTOS!                                      \
+ * Example:                                                                                    \
+ * @code                                                                                       \
+ * APP_log_level_e saved = APP_set_thread_level(APP_LOG_LEVEL_DEBUG);                          \
+ * handle_request(req);                                                                        \
+ * APP_set_thread_level(saved);                                                                \
+ * @endcode                                                                                    \
  */                                                                                            \
-static inline void TAG##_log_write(TAG##_log_level_e level, const char* tag_str,               \
-                                   const char* fmt, ...)                                       \
+static inline TAG##_log_level_e TAG##_set_thread_level(TAG##_log_level_e level)                \
 {                                                                                              \
-    /* Fast path: Check enable flags first (minimize overhead when disabled) */                \
-    if (!TAG##_log_enabled || level < TAG##_log_min_level) { return; }                         \
+    TAG##_log_level_e previous = TAG##_log_thread_level;                                       \
+    TAG##_log_thread_level = level;                                                            \
+    return previous;                                                                           \
+}                                                                                              \
                                                                                                \
-    /* Early exit if callback not registered or format string is NULL */                       \
-    if (TAG##_log_handler == NULL || fmt == NULL) { return; }                                  \
+/**                                                                                            \
+ * @brief Get the calling thread's level override                                              \
+ * @return Override level, TAG_LOG_LEVEL_NONE when no override is active                       \
+ */                                                                                            \
+static inline TAG##_log_level_e TAG##_get_thread_level(void)                                   \
+{                                                                                              \
+    return TAG##_log_thread_level;                                                             \
+}                                                                                              \
                                                                                                \
-    const char* level_str;                                                                     \
-    char buffer[MAX_LENGTH];                                                                   \
-    va_list args;                                                                              \
-    size_t offset = 0;                                                                         \
-    int result = 0;                                                                            \
+/* Scope-exit hook of HOL_LOG_LEVEL_SCOPE() */                                                 \
+static inline void TAG##_log_thread_restore(int* saved)                                        \
+{                                                                                              \
+    TAG##_log_thread_level = (TAG##_log_level_e)*saved;                                        \
+}                                                                                              \
                                                                                                \
-    /* Clear buffer to prevent garbage data */                                                 \
-    memset(buffer, 0, sizeof(buffer));                                                         \
+/**                                                                                            \
+ * @brief Configure adaptive load shedding                                                     \
+ * @param clock Tick source used to time each callback (NULL: feed samples manually)           \
+ * @param high  Sink latency (ticks) above which a sample counts as pressure                   \
+ * @param low   Sink latency (ticks) below which a sample counts as recovery                   \
+ * @param hold  Consecutive samples required per level step (0 disables shedding)              \
+ *                                                                                             \
+ * Under sustained pressure the effective level rises DEBUG -> INFO -> WARNING ->              \
+ * ERROR one step at a time, and steps back down once the sink recovers. With a                \
+ * clock, lines shed while the sink is idle also count as recovery samples.                    \
+ *                                                                                             \
+ * Example:                                                                                    \
+ * @code                                                                                       \
+ * // Shed after 4 callbacks slower than 5 ms, restore after 4 faster than 1 ms                \
+ * APP_set_shed_policy(HAL_GetTick, 5, 1, 4);                                                  \
+ * @endcode                                                                                    \
+ */                                                                                            \
+static inline void TAG##_set_shed_policy(hol_log_clock_t clock, uint32_t high,                 \
+                                         uint32_t low, uint8_t hold)                           \
+{                                                                                              \
+    TAG##_log_state.clock = clock;                                                             \
+    TAG##_log_state.shed.high_watermark = high;                                                \
+    TAG##_log_state.shed.low_watermark = low;                                                  \
+    TAG##_log_state.shed.hold = hold;                                                          \
+    TAG##_log_state.shed.hot_streak = 0;                                                       \
+    TAG##_log_state.shed.cool_streak = 0;                                                      \
+    TAG##_log_state.shed.last_sample = (clock != NULL) ? clock() : 0u;                         \
+    if (hold == 0) { TAG##_log_state.shed.floor = 0; }                                         \
+    hol_log_state_refresh(&TAG##_log_state);                                                   \
+}                                                                                              \
                                                                                                \
-    /* Map log level to single character prefix */                                             \
-    switch (level)                                                                             \
+/**                                                                                            \
+ * @brief Feed an external pressure sample (e.g. queue occupancy) to the shedder               \
+ * @param sample Pressure sample in the same unit as the configured watermarks                 \
+ */                                                                                            \
+static inline void TAG##_log_shed_feed(uint32_t sample)                                        \
+{                                                                                              \
+    if (hol_log_shed_feed(&TAG##_log_state.shed, sample))                                      \
     {                                                                                          \
-        case TAG##_LOG_LEVEL_DEBUG:   level_str = "D"; break;                                  \
-        case TAG##_LOG_LEVEL_INFO:    level_str = "I"; break;                                  \
-        case TAG##_LOG_LEVEL_WARNING: level_str = "W"; break;                                  \
-        case TAG##_LOG_LEVEL_ERROR:   level_str = "E"; break;                                  \
-        default:                      level_str = "?"; break;                                  \
+        hol_log_state_refresh(&TAG##_log_state);                                               \
     }                                                                                          \
+}                                                                                              \
                                                                                                \
-    /* Build prefix: [LEVEL] (TAG): */                                                         \
-    result = snprintf(buffer, sizeof(buffer), "[%s] (%s): ", level_str, tag_str);              \
-    if (result < 0 || (size_t)result >= sizeof(buffer))                                        \
-    {                                                                                          \
-        /* Format error or buffer too small - abort safely */                                  \
-        return;                                                                                \
-    }                                                                                          \
-    offset = (size_t)result;                                                                   \
+/**                                                                                            \
+ * @brief Read load shedding counters (raises, restores, shed lines per level)                 \
+ * @return Pointer to the TAG's shedding state (read-only)                                     \
+ */                                                                                            \
+static inline const hol_log_shed_t* TAG##_get_shed_stats(void)                                 \
+{                                                                                              \
+    return &TAG##_log_state.shed;                                                              \
+}                                                                                              \
                                                                                                \
-    /* Append user message with format arguments */                                            \
-    va_start(args, fmt);                                                                       \
-    result = vsnprintf(&buffer[offset], sizeof(buffer) - offset, fmt, args);                   \
-    va_end(args);                                                                              \
+/**                                                                                            \
+ * @brief Switch this TAG to binary (deferred-format) output                                   \
+ * @param stream Binary stream initialised with hol_log_binary_init(), NULL for text output    \
+ *                                                                                             \
+ * In binary mode TAG_LOG_* calls skip printf formatting: they write the format-string ID      \
+ * and raw arguments to the stream. Decode offline with Tools/hol_log_decode.                  \
+ */                                                                                            \
+static inline void TAG##_set_binary_stream(hol_log_binary_t* stream)                           \
+{                                                                                              \
+    TAG##_log_state.binary = stream;                                                           \
+}                                                                                              \
                                                                                                \
-    if (result < 0)                                                                            \
+/**                                                                                            \
+ * @brief Switch this TAG's text output to JSON lines                                          \
+ * @param enable true: {"level":"INFO","tag":"TAG",...,"msg":"..."}\n, false: plain text       \
+ *                                                                                             \
+ * Level and tag are compile-time literals; only the message (and the thread                   \
+ * context, once per hol_log_set_context()) goes through the JSON escaper.                     \
+ * JSON lines are longer than text lines: size MAX_LENGTH accordingly.                         \
+ */                                                                                            \
+static inline void TAG##_set_json_output(bool enable)                                          \
+{                                                                                              \
+    static const hol_log_json_head_t heads[4] =                                                \
     {                                                                                          \
-        /* Format string error - abort safely */                                               \
-        return;                                                                                \
-    }                                                                                          \
+        HOL_LOG_JSON_HEAD("DEBUG", #TAG),                                                      \
+        HOL_LOG_JSON_HEAD("INFO", #TAG),                                                       \
+        HOL_LOG_JSON_HEAD("WARNING", #TAG),                                                    \
+        HOL_LOG_JSON_HEAD("ERROR", #TAG),                                                      \
+    };                                                                                         \
+    TAG##_log_state.json = enable ? heads : NULL;                                              \
+}                                                                                              \
                                                                                                \
-    /* Handle truncation if message exceeds buffer */                                          \
-    if ((size_t)result >= sizeof(buffer) - offset)                                             \
-    {                                                                                          \
-        /* Message truncated - reserve space for line ending */                                \
-        offset = sizeof(buffer) - 3;  /* Reserve for \r\n\0 */                                 \
-    }                                                                                          \
-    else                                                                                       \
-    {                                                                                          \
-        offset += (size_t)result;                                                              \
-    }                                                                                          \
+/**                                                                                            \
+ * @brief Select the categories TAG_LOG_CAT() lets through                                     \
+ * @param mask Bitwise OR of user-defined category bits (LOG_CATEGORY_ALL = every category)    \
+ *                                                                                             \
+ * Example:                                                                                    \
+ * @code                                                                                       \
+ * #define NET_CAT_SOCKET (1u << 0)                                                            \
+ * #define NET_CAT_TLS    (1u << 1)                                                            \
+ * #define NET_CAT_DNS    (1u << 2)                                                            \
+ *                                                                                             \
+ * NET_set_category_mask(NET_CAT_TLS | NET_CAT_DNS);   // Silence socket chatter               \
+ * @endcode                                                                                    \
+ */                                                                                            \
+static inline void TAG##_set_category_mask(hol_log_category_t mask)                            \
+{                                                                                              \
+    TAG##_log_state.category_mask = mask;                                                      \
+}                                                                                              \
                                                                                                \
-    /* Append CRLF line ending (compatible with most terminals/UARTs) */                       \
-    if (offset < sizeof(buffer) - 2)                                                           \
-    {                                                                                          \
-        buffer[offset++] = '\r';                                                               \
-        buffer[offset++] = '\n';                                                               \
-        buffer[offset] = '\0';                                                                 \
-    }                                                                                          \
+/**                                                                                            \
+ * @brief Get the current category mask                                                        \
+ * @return Categories enabled for TAG_LOG_CAT()                                                \
+ */                                                                                            \
+static inline hol_log_category_t TAG##_get_category_mask(void)                                 \
+{                                                                                              \
+    return TAG##_log_state.category_mask;                                                      \
+}                                                                                              \
                                                                                                \
-    /* Invoke user callback with formatted message */                                          \
-    (void)TAG##_log_handler(buffer);                                                           \
+/**                                                                                            \
+ * @brief Core logging function with level filtering                                           \
+ * @param level   Log level                                                                    \
+ * @param tag_str Unused, the TAG name comes from the logger state                             \
+ * @param fmt     Printf-style format string                                                   \
+ * @param ...     Variadic arguments                                                           \
+ *                                                                                             \
+ * Thin wrapper over the shared core; TAG_LOG_* call the core directly.                        \
+ */                                                                                            \
+static inline void TAG##_log_write(TAG##_log_level_e level, const char* tag_str,               \
+                                   const char* fmt, ...)                                       \
+{                                                                                              \
+    (void)tag_str;                                                                             \
+    if (level >= TAG##_LOG_LEVEL_NONE || !TAG##_log_should_emit(level)) { return; }            \
+    char buffer[MAX_LENGTH];                                                                   \
+    va_list args;                                                                              \
+    va_start(args, fmt);                                                                       \
+    hol_log_vwrite(&TAG##_log_state, (int)level, buffer, sizeof(buffer), fmt, args);           \
+    va_end(args);                                                                              \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -344,15 +1551,13 @@ static inline void TAG##_log_write(TAG##_log_level_e level, const char* tag_str,
  */                                                                                            \
 static inline void TAG##_LOG_ERROR(const char* fmt, ...)                                       \
 {                                                                                              \
-    if (!TAG##_log_enabled || TAG##_LOG_LEVEL_ERROR < TAG##_log_min_level) { return; }         \
+    if (!TAG##_log_should_emit(TAG##_LOG_LEVEL_ERROR)) { return; }                             \
+    char buffer[MAX_LENGTH];                                                                   \
     va_list args;                                                                              \
     va_start(args, fmt);                                                                       \
-    char temp_fmt[LOG_INTERNAL_BUFFER];                                                        \
-    int len = vsnprintf(temp_fmt, sizeof(temp_fmt), fmt, args);                                \
+    hol_log_vwrite(&TAG##_log_state, TAG##_LOG_LEVEL_ERROR, buffer, sizeof(buffer),            \
+                   fmt, args);                                                                 \
     va_end(args);                                                                              \
-    if (len > 0) {                                                                             \
-        TAG##_log_write(TAG##_LOG_LEVEL_ERROR, #TAG, "%s", temp_fmt);                          \
-    }                                                                                          \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -364,15 +1569,13 @@ static inline void TAG##_LOG_ERROR(const char* fmt, ...)
  */                                                                                            \
 static inline void TAG##_LOG_WARNING(const char* fmt, ...)                                     \
 {                                                                                              \
-    if (!TAG##_log_enabled || TAG##_LOG_LEVEL_WARNING < TAG##_log_min_level) { return; }       \
+    if (!TAG##_log_should_emit(TAG##_LOG_LEVEL_WARNING)) { return; }                           \
+    char buffer[MAX_LENGTH];                                                                   \
     va_list args;                                                                              \
     va_start(args, fmt);                                                                       \
-    char temp_fmt[LOG_INTERNAL_BUFFER];                                                        \
-    int len = vsnprintf(temp_fmt, sizeof(temp_fmt), fmt, args);                                \
+    hol_log_vwrite(&TAG##_log_state, TAG##_LOG_LEVEL_WARNING, buffer, sizeof(buffer),          \
+                   fmt, args);                                                                 \
     va_end(args);                                                                              \
-    if (len > 0) {                                                                             \
-        TAG##_log_write(TAG##_LOG_LEVEL_WARNING, #TAG, "%s", temp_fmt);                        \
-    }                                                                                          \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -384,15 +1587,13 @@ static inline void TAG##_LOG_WARNING(const char* fmt, ...)
  */                                                                                            \
 static inline void TAG##_LOG_INFO(const char* fmt, ...)                                        \
 {                                                                                              \
-    if (!TAG##_log_enabled || TAG##_LOG_LEVEL_INFO < TAG##_log_min_level) { return; }          \
+    if (!TAG##_log_should_emit(TAG##_LOG_LEVEL_INFO)) { return; }                              \
+    char buffer[MAX_LENGTH];                                                                   \
     va_list args;                                                                              \
     va_start(args, fmt);                                                                       \
-    char temp_fmt[LOG_INTERNAL_BUFFER];                                                        \
-    int len = vsnprintf(temp_fmt, sizeof(temp_fmt), fmt, args);                                \
+    hol_log_vwrite(&TAG##_log_state, TAG##_LOG_LEVEL_INFO, buffer, sizeof(buffer),             \
+                   fmt, args);                                                                 \
     va_end(args);                                                                              \
-    if (len > 0) {                                                                             \
-        TAG##_log_write(TAG##_LOG_LEVEL_INFO, #TAG, "%s", temp_fmt);                           \
-    }                                                                                          \
 }                                                                                              \
                                                                                                \
 /**                                                                                            \
@@ -404,15 +1605,610 @@ static inline void TAG##_LOG_INFO(const char* fmt, ...)
  */                                                                                            \
 static inline void TAG##_LOG_DEBUG(const char* fmt, ...)                                       \
 {                                                                                              \
-    if (!TAG##_log_enabled || TAG##_LOG_LEVEL_DEBUG < TAG##_log_min_level) { return; }         \
+    if (!TAG##_log_should_emit(TAG##_LOG_LEVEL_DEBUG)) { return; }                             \
+    char buffer[MAX_LENGTH];                                                                   \
     va_list args;                                                                              \
     va_start(args, fmt);                                                                       \
-    char temp_fmt[LOG_INTERNAL_BUFFER];                                                        \
-    int len = vsnprintf(temp_fmt, sizeof(temp_fmt), fmt, args);                                \
+    hol_log_vwrite(&TAG##_log_state, TAG##_LOG_LEVEL_DEBUG, buffer, sizeof(buffer),            \
+                   fmt, args);                                                                 \
     va_end(args);                                                                              \
-    if (len > 0) {                                                                             \
-        TAG##_log_write(TAG##_LOG_LEVEL_DEBUG, #TAG, "%s", temp_fmt);                          \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Category-filtered logging                                                            \
+ * @param cat   Category bit(s) of this line                                                   \
+ * @param level Log level (TAG_LOG_LEVEL_DEBUG ... TAG_LOG_LEVEL_ERROR)                        \
+ * @param fmt   Printf-style format string                                                     \
+ * @param ...   Variadic arguments                                                             \
+ *                                                                                             \
+ * The line is dropped before any formatting unless cat intersects the category mask;          \
+ * the level filter then applies as for TAG_LOG_*.                                             \
+ *                                                                                             \
+ * Usage: NET_LOG_CAT(NET_CAT_TLS, NET_LOG_LEVEL_DEBUG, "Handshake: %s", state);               \
+ */                                                                                            \
+static inline void TAG##_LOG_CAT(hol_log_category_t cat, TAG##_log_level_e level,              \
+                                 const char* fmt, ...)                                         \
+{                                                                                              \
+    if ((cat & TAG##_log_state.category_mask) == 0) { return; }                                \
+    if (level >= TAG##_LOG_LEVEL_NONE || !TAG##_log_should_emit(level)) { return; }            \
+    char buffer[MAX_LENGTH];                                                                   \
+    va_list args;                                                                              \
+    va_start(args, fmt);                                                                       \
+    hol_log_vwrite(&TAG##_log_state, (int)level, buffer, sizeof(buffer), fmt, args);           \
+    va_end(args);                                                                              \
+}
+
+/* ==================== DEFERRED (ASYNC) MODE ==================== */
+
+/**
+ * @brief Memory barrier ordering a lane slot write before its index update
+ * @note Override with your core's barrier (e.g. __DMB()) if needed.
+ */
+#ifndef LOG_MEMORY_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_MEMORY_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define LOG_MEMORY_BARRIER() do { } while (0)
+#endif
+#endif
+
+/**
+ * @brief Single-producer/single-consumer lane indices (one lane per level)
+ * @note head is only written by the producer, tail only by the flusher, so a
+ *       lane may be filled from an ISR and drained from the main loop.
+ */
+typedef struct {
+    volatile size_t head;    /* Free-running write counter (producer) */
+    volatile size_t tail;    /* Free-running read counter (flusher) */
+    uint32_t drops;          /* Lines dropped because this lane was full */
+} hol_log_lane_t;
+
+/**
+ * @brief Add a deferred, priority-aware output path to an existing TAG
+ * @param TAG         TAG previously declared with DECLARE_LOG
+ * @param MAX_LENGTH  Slot size per line (use the TAG's MAX_LENGTH)
+ * @param LANE_DEPTH  Lines buffered per level
+ *
+ * Each level gets its own bounded lane, so a DEBUG flood can only fill the
+ * DEBUG lane: WARNING and ERROR lines keep their full capacity. The flusher
+ * drains ERROR first, then WARNING, INFO and DEBUG; order within one level
+ * is preserved. A full lane drops the new line and counts it.
+ *
+ * RAM: 4 * LANE_DEPTH * MAX_LENGTH bytes of line storage per TAG.
+ *
+ * @warning Lanes are single-producer: all TAG_LOG_* calls of this TAG must come
+ *          from one context (one thread, or one ISR that never preempts another
+ *          logger of the TAG). Two concurrent producers can claim the same slot
+ *          and overwrite each other's line. Use DECLARE_LOG_DEFERRED_PERCPU when
+ *          several threads log to one TAG. The flusher may run in a second context.
+ *
+ * @note Generated functions:
+ *   - TAG_log_deferred_enable()      : Queue lines instead of calling the callback
+ *   - TAG_log_deferred_disable()     : Flush remaining lines, return to direct output
+ *   - TAG_log_flush(max_lines)       : Send up to max_lines queued lines (0 = all)
+ *   - TAG_log_deferred_pending()     : Number of queued lines (all levels)
+ *   - TAG_log_drop_count(level)      : Lines dropped at a level because its lane was full
+ *
+ * Usage Example:
+ * @code
+ * DECLARE_LOG(APP, 128, void)
+ * DECLARE_LOG_DEFERRED(APP, 128, 8)
+ *
+ * APP_set_callback(uart_send);
+ * APP_log_deferred_enable();
+ * APP_LOG_ERROR("Overcurrent");        // Cheap: formatted into the ERROR lane
+ *
+ * void idle_task(void) {
+ *     APP_log_flush(4);                // ERROR lines go out first
+ * }
+ * @endcode
+ */
+#define DECLARE_LOG_DEFERRED(TAG, MAX_LENGTH, LANE_DEPTH)                                      \
+                                                                                               \
+static char TAG##_log_lane_slots[TAG##_LOG_LEVEL_NONE][LANE_DEPTH][MAX_LENGTH];                \
+static hol_log_lane_t TAG##_log_lanes[TAG##_LOG_LEVEL_NONE];                                   \
+                                                                                               \
+/* Producer side: copy a formatted line into its level lane (drop if full) */                  \
+static inline bool TAG##_log_lane_push(int level, const char* line, size_t len)                \
+{                                                                                              \
+    if ((unsigned)level >= (unsigned)TAG##_LOG_LEVEL_NONE) { return false; }                   \
+                                                                                               \
+    hol_log_lane_t* lane = &TAG##_log_lanes[level];                                            \
+    size_t head = lane->head;                                                                  \
+    if (head - lane->tail >= (size_t)(LANE_DEPTH))                                             \
+    {                                                                                          \
+        lane->drops++;                                                                         \
+        return false;                                                                          \
+    }                                                                                          \
+                                                                                               \
+    char* slot = TAG##_log_lane_slots[level][head % (LANE_DEPTH)];                             \
+    if (len >= (size_t)(MAX_LENGTH)) { len = (size_t)(MAX_LENGTH) - 1; }                       \
+    memcpy(slot, line, len);                                                                   \
+    slot[len] = '\0';                                                                          \
+                                                                                               \
+    LOG_MEMORY_BARRIER();   /* Slot contents visible before the new head */                    \
+    lane->head = head + 1;                                                                     \
+    return true;                                                                               \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Send queued lines to the callback, highest level first                               \
+ * @param max_lines Maximum lines to send in this call (0 = until all lanes are empty)         \
+ * @return Number of lines sent                                                                \
+ */                                                                                            \
+static inline size_t TAG##_log_flush(size_t max_lines)                                         \
+{                                                                                              \
+    size_t sent = 0;                                                                           \
+    if (!TAG##_log_has_output()) { return 0; }                                                 \
+                                                                                               \
+    for (int level = (int)TAG##_LOG_LEVEL_ERROR; level >= 0; )                                 \
+    {                                                                                          \
+        hol_log_lane_t* lane = &TAG##_log_lanes[level];                                        \
+        size_t tail = lane->tail;                                                              \
+        if (tail == lane->head)                                                                \
+        {                                                                                      \
+            level--;                                                                           \
+            continue;                                                                          \
+        }                                                                                      \
+                                                                                               \
+        LOG_MEMORY_BARRIER();   /* Read the slot only after observing head */                  \
+        const char* line = TAG##_log_lane_slots[level][tail % (LANE_DEPTH)];                   \
+        hol_log_emit(&TAG##_log_state, level, line, strlen(line));                             \
+        LOG_MEMORY_BARRIER();   /* Finish reading before releasing the slot */                 \
+        lane->tail = tail + 1;                                                                 \
+                                                                                               \
+        if (++sent == max_lines) { break; }                                                    \
+        /* Re-check from the top: a new ERROR may have arrived meanwhile */                    \
+        level = (int)TAG##_LOG_LEVEL_ERROR;                                                    \
+    }                                                                                          \
+    return sent;                                                                               \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Route this TAG's output through the priority lanes                                   \
+ */                                                                                            \
+static inline void TAG##_log_deferred_enable(void)                                             \
+{                                                                                              \
+    TAG##_log_state.defer = TAG##_log_lane_push;                                               \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Return to direct callback output after flushing what is queued                       \
+ */                                                                                            \
+static inline void TAG##_log_deferred_disable(void)                                            \
+{                                                                                              \
+    TAG##_log_state.defer = NULL;                                                              \
+    (void)TAG##_log_flush(0);                                                                  \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Number of lines waiting in all lanes                                                 \
+ */                                                                                            \
+static inline size_t TAG##_log_deferred_pending(void)                                          \
+{                                                                                              \
+    size_t pending = 0;                                                                        \
+    for (int level = 0; level < (int)TAG##_LOG_LEVEL_NONE; level++)                            \
+    {                                                                                          \
+        pending += TAG##_log_lanes[level].head - TAG##_log_lanes[level].tail;                  \
+    }                                                                                          \
+    return pending;                                                                            \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Lines dropped at a level because its lane was full                                   \
+ */                                                                                            \
+static inline uint32_t TAG##_log_drop_count(TAG##_log_level_e level)                           \
+{                                                                                              \
+    if ((unsigned)level >= (unsigned)TAG##_LOG_LEVEL_NONE) { return 0; }                       \
+    return TAG##_log_lanes[level].drops;                                                       \
+}
+
+/* ==================== PER-CPU DEFERRED MODE ==================== */
+
+/**
+ * @brief Thread-local address hash, used as a shard hint when no CPU id is available
+ */
+static inline uint32_t hol_log_thread_hash(void)
+{
+    static HOL_LOG_THREAD_LOCAL uint8_t anchor;
+    return (uint32_t)((((uintptr_t)&anchor >> 4) * 2654435761u) >> 16);
+}
+
+/**
+ * @brief CPU number of the calling thread, used to pick a per-CPU shard
+ * @note Default on Linux with glibc >= 2.35: cpu_id_start from the rseq area
+ *       glibc registers for every thread (one thread-pointer-relative load,
+ *       no syscall). Falls back to hol_log_thread_hash() when rseq is not
+ *       registered or not available. Override with your core id register
+ *       on SMP MCUs. The value only needs to be a good hint: a migrated
+ *       thread simply lands on a neighbouring shard.
+ */
+#ifndef LOG_CPU_ID
+#if defined(__linux__) && defined(__GLIBC__) && defined(__has_include) && defined(__has_builtin)
+#if __has_include(<sys/rseq.h>) && __has_builtin(__builtin_thread_pointer)
+#include <sys/rseq.h>
+
+static inline uint32_t hol_log_rseq_cpu(void)
+{
+    if (__rseq_size == 0) { return hol_log_thread_hash(); }   /* rseq disabled (tunable/kernel) */
+    const struct rseq* area =
+        (const struct rseq*)((char*)__builtin_thread_pointer() + __rseq_offset);
+    return __atomic_load_n(&area->cpu_id_start, __ATOMIC_RELAXED);
+}
+
+#define LOG_CPU_ID() hol_log_rseq_cpu()
+#endif
+#endif
+#endif
+
+#ifndef LOG_CPU_ID
+#define LOG_CPU_ID() hol_log_thread_hash()
+#endif
+
+/**
+ * @brief Non-blocking shard ownership (producer side) and drop counter update
+ * @note Without GCC atomics these fall back to plain accesses, which is only
+ *       safe when a single core produces (use DECLARE_LOG_DEFERRED there).
+ */
+#ifndef LOG_SHARD_TRY_LOCK
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_SHARD_TRY_LOCK(flag) (__atomic_exchange_n((flag), 1, __ATOMIC_ACQUIRE) == 0)
+#define LOG_SHARD_UNLOCK(flag)   __atomic_store_n((flag), 0, __ATOMIC_RELEASE)
+#define LOG_ATOMIC_INC(counter)  (void)__atomic_fetch_add((counter), 1, __ATOMIC_RELAXED)
+#else
+#define LOG_SHARD_TRY_LOCK(flag) ((*(flag) == 0) ? (*(flag) = 1, true) : false)
+#define LOG_SHARD_UNLOCK(flag)   (*(flag) = 0)
+#define LOG_ATOMIC_INC(counter)  ((*(counter))++)
+#endif
+#endif
+
+/**
+ * @brief Keeps each shard on its own cache line (no false sharing between CPUs)
+ */
+#ifndef HOL_LOG_CACHE_ALIGNED
+#if defined(__GNUC__) || defined(__clang__)
+#define HOL_LOG_CACHE_ALIGNED __attribute__((aligned(64)))
+#else
+#define HOL_LOG_CACHE_ALIGNED
+#endif
+#endif
+
+/**
+ * @brief Per-CPU variant of DECLARE_LOG_DEFERRED for multi-core producers
+ * @param TAG         TAG previously declared with DECLARE_LOG
+ * @param MAX_LENGTH  Slot size per line (use the TAG's MAX_LENGTH)
+ * @param LANE_DEPTH  Lines buffered per level and per shard
+ * @param SHARDS      Number of shards (normally the CPU count)
+ *
+ * Generates the same functions as DECLARE_LOG_DEFERRED, so switching is a
+ * one-line change. Each shard owns a full set of priority lanes and sits on
+ * its own cache line. A producer appends to the shard of the CPU it runs
+ * on (LOG_CPU_ID()), taking it with a single uncontended atomic exchange:
+ * threads on different CPUs never touch the same lane, and a thread that
+ * was preempted mid-append only diverts others to the next free shard. A
+ * line is dropped (and counted) when its lane is full or every shard is
+ * busy. Nothing ever blocks.
+ *
+ * The flusher scans SHARDS lane sets instead of one per thread. It drains
+ * ERROR lanes first; once it finds a non-empty lane it sends the lines
+ * queued there, then checks from ERROR again, so a higher-level line waits
+ * for at most LANE_DEPTH lines. Order is preserved per level within a
+ * shard, not across shards. Use one flusher.
+ *
+ * RAM: SHARDS * 4 * LANE_DEPTH * MAX_LENGTH bytes of line storage per TAG.
+ *
+ * Usage Example:
+ * @code
+ * DECLARE_LOG(APP, 128, void)
+ * DECLARE_LOG_DEFERRED_PERCPU(APP, 128, 16, 8)   // Up to 8 CPUs
+ *
+ * APP_set_callback(write_stderr);
+ * APP_log_deferred_enable();
+ * // Any thread: APP_LOG_INFO(...) lands in its CPU's shard
+ * // Flusher thread: APP_log_flush(0);
+ * @endcode
+ */
+#define DECLARE_LOG_DEFERRED_PERCPU(TAG, MAX_LENGTH, LANE_DEPTH, SHARDS)                       \
+                                                                                               \
+typedef struct {                                                                               \
+    hol_log_lane_t lanes[TAG##_LOG_LEVEL_NONE];                                                \
+    volatile uint8_t busy;                      /* Owned by a producer while appending */      \
+} TAG##_log_shard_t;                                                                           \
+                                                                                               \
+static char TAG##_log_lane_slots[SHARDS][TAG##_LOG_LEVEL_NONE][LANE_DEPTH][MAX_LENGTH];        \
+static HOL_LOG_CACHE_ALIGNED TAG##_log_shard_t TAG##_log_shards[SHARDS];                       \
+static uint32_t TAG##_log_busy_drops[TAG##_LOG_LEVEL_NONE];                                    \
+static uint32_t TAG##_log_flush_cursor;                                                        \
+                                                                                               \
+/* Producer side: append to this CPU's shard, or the next free one */                          \
+static inline bool TAG##_log_lane_push(int level, const char* line, size_t len)                \
+{                                                                                              \
+    if ((unsigned)level >= (unsigned)TAG##_LOG_LEVEL_NONE) { return false; }                   \
+                                                                                               \
+    uint32_t start = (uint32_t)LOG_CPU_ID() % (uint32_t)(SHARDS);                              \
+    for (uint32_t probe = 0; probe < (uint32_t)(SHARDS); probe++)                              \
+    {                                                                                          \
+        uint32_t index = start + probe;                                                        \
+        if (index >= (uint32_t)(SHARDS)) { index -= (uint32_t)(SHARDS); }                      \
+        TAG##_log_shard_t* shard = &TAG##_log_shards[index];                                   \
+        if (!LOG_SHARD_TRY_LOCK(&shard->busy)) { continue; }                                   \
+                                                                                               \
+        hol_log_lane_t* lane = &shard->lanes[level];                                           \
+        size_t head = lane->head;                                                              \
+        bool stored = (head - lane->tail < (size_t)(LANE_DEPTH));                              \
+        if (stored)                                                                            \
+        {                                                                                      \
+            char* slot = TAG##_log_lane_slots[index][level][head % (LANE_DEPTH)];              \
+            if (len >= (size_t)(MAX_LENGTH)) { len = (size_t)(MAX_LENGTH) - 1; }               \
+            memcpy(slot, line, len);                                                           \
+            slot[len] = '\0';                                                                  \
+            LOG_MEMORY_BARRIER();   /* Slot contents visible before the new head */            \
+            lane->head = head + 1;                                                             \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+            lane->drops++;                                                                     \
+        }                                                                                      \
+        LOG_SHARD_UNLOCK(&shard->busy);                                                        \
+        return stored;                                                                         \
+    }                                                                                          \
+                                                                                               \
+    LOG_ATOMIC_INC(&TAG##_log_busy_drops[level]);                                              \
+    return false;                                                                              \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Send queued lines from all shards to the callback, highest level first               \
+ * @param max_lines Maximum lines to send in this call (0 = until all lanes are empty)         \
+ * @return Number of lines sent                                                                \
+ */                                                                                            \
+static inline size_t TAG##_log_flush(size_t max_lines)                                         \
+{                                                                                              \
+    size_t sent = 0;                                                                           \
+    if (!TAG##_log_has_output()) { return 0; }                                                 \
+                                                                                               \
+    for (int level = (int)TAG##_LOG_LEVEL_ERROR; level >= 0; )                                 \
+    {                                                                                          \
+        uint32_t index = 0;                                                                    \
+        hol_log_lane_t* lane = NULL;                                                           \
+        for (uint32_t probe = 0; probe < (uint32_t)(SHARDS); probe++)                          \
+        {                                                                                      \
+            index = (TAG##_log_flush_cursor + probe) % (uint32_t)(SHARDS);                     \
+            hol_log_lane_t* candidate = &TAG##_log_shards[index].lanes[level];                 \
+            if (candidate->tail != candidate->head)                                            \
+            {                                                                                  \
+                lane = candidate;                                                              \
+                break;                                                                         \
+            }                                                                                  \
+        }                                                                                      \
+        if (lane == NULL)                                                                      \
+        {                                                                                      \
+            level--;                                                                           \
+            continue;                                                                          \
+        }                                                                                      \
+                                                                                               \
+        /* Drain what this lane holds now; start the next scan at the next shard */            \
+        TAG##_log_flush_cursor = (index + 1) % (uint32_t)(SHARDS);                             \
+        size_t tail = lane->tail;                                                              \
+        size_t head = lane->head;                                                              \
+        LOG_MEMORY_BARRIER();   /* Read the slots only after observing head */                 \
+        while (tail != head)                                                                   \
+        {                                                                                      \
+            const char* line = TAG##_log_lane_slots[index][level][tail % (LANE_DEPTH)];        \
+            hol_log_emit(&TAG##_log_state, level, line, strlen(line));                         \
+            LOG_MEMORY_BARRIER();   /* Finish reading before releasing the slot */             \
+            lane->tail = ++tail;                                                               \
+            if (++sent == max_lines) { return sent; }                                          \
+        }                                                                                      \
+                                                                                               \
+        /* Re-check from the top: a new ERROR may have arrived meanwhile */                    \
+        level = (int)TAG##_LOG_LEVEL_ERROR;                                                    \
     }                                                                                          \
+    return sent;                                                                               \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Route this TAG's output through the per-CPU lanes                                    \
+ */                                                                                            \
+static inline void TAG##_log_deferred_enable(void)                                             \
+{                                                                                              \
+    TAG##_log_state.defer = TAG##_log_lane_push;                                               \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Return to direct callback output after flushing what is queued                       \
+ */                                                                                            \
+static inline void TAG##_log_deferred_disable(void)                                            \
+{                                                                                              \
+    TAG##_log_state.defer = NULL;                                                              \
+    (void)TAG##_log_flush(0);                                                                  \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Number of lines waiting in all shards                                                \
+ */                                                                                            \
+static inline size_t TAG##_log_deferred_pending(void)                                          \
+{                                                                                              \
+    size_t pending = 0;                                                                        \
+    for (uint32_t index = 0; index < (uint32_t)(SHARDS); index++)                              \
+    {                                                                                          \
+        for (int level = 0; level < (int)TAG##_LOG_LEVEL_NONE; level++)                        \
+        {                                                                                      \
+            const hol_log_lane_t* lane = &TAG##_log_shards[index].lanes[level];                \
+            pending += lane->head - lane->tail;                                                \
+        }                                                                                      \
+    }                                                                                          \
+    return pending;                                                                            \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Lines dropped at a level (full lane in any shard, or every shard busy)               \
+ */                                                                                            \
+static inline uint32_t TAG##_log_drop_count(TAG##_log_level_e level)                           \
+{                                                                                              \
+    if ((unsigned)level >= (unsigned)TAG##_LOG_LEVEL_NONE) { return 0; }                       \
+    uint32_t drops = TAG##_log_busy_drops[level];                                              \
+    for (uint32_t index = 0; index < (uint32_t)(SHARDS); index++)                              \
+    {                                                                                          \
+        drops += TAG##_log_shards[index].lanes[level].drops;                                   \
+    }                                                                                          \
+    return drops;                                                                              \
+}
+
+/* ==================== RECENT RECORDS (IN-MEMORY) ==================== */
+
+/**
+ * @brief Atomically claim the next record number (returns the previous value)
+ */
+#ifndef LOG_ATOMIC_FETCH_INC
+#if defined(__GNUC__) || defined(__clang__)
+#define LOG_ATOMIC_FETCH_INC(counter) __atomic_fetch_add((counter), 1u, __ATOMIC_RELAXED)
+#else
+#define LOG_ATOMIC_FETCH_INC(counter) ((*(counter))++)
+#endif
+#endif
+
+/**
+ * @brief Keep the last DEPTH formatted lines per level in RAM for diagnostics
+ * @param TAG        TAG previously declared with DECLARE_LOG
+ * @param DEPTH      Lines kept per level (oldest overwritten)
+ * @param LINE_SIZE  Bytes kept per line (longer lines are cut)
+ *
+ * Every formatted text or JSON line at or above the recording level is
+ * copied into its level's ring at log time, also in deferred mode, so a
+ * health endpoint can answer "last N errors" without reading the log file.
+ * Binary-mode records are not formatted and are not kept.
+ *
+ * Snapshots are lock-free: each slot carries a sequence number that is odd
+ * while the line is written. A reader copies a slot and keeps it only if
+ * the number is unchanged and matches the record it expected; lines
+ * overwritten meanwhile are skipped, never returned torn. Writers claim
+ * slots with an atomic increment, so per-CPU deferred producers can record
+ * concurrently.
+ *
+ * RAM: 4 * DEPTH * (LINE_SIZE + 8) bytes per TAG.
+ *
+ * @note Generated functions:
+ *   - TAG_log_recent_enable(level)                   : Record lines at level and above
+ *   - TAG_log_recent_disable()                       : Stop recording (rings are kept)
+ *   - TAG_log_recent_snapshot(level, max, out, size) : Copy the newest lines, oldest first
+ *   - TAG_log_recent_total(level)                    : Lines recorded at a level so far
+ *
+ * Usage Example:
+ * @code
+ * DECLARE_LOG(APP, 256, void)
+ * DECLARE_LOG_RECENT(APP, 100, 160)
+ *
+ * APP_log_recent_enable(APP_LOG_LEVEL_WARNING);
+ *
+ * void health_handler(void) {
+ *     static char body[100 * 160];
+ *     size_t lines = APP_log_recent_snapshot(APP_LOG_LEVEL_ERROR, 100, body, sizeof(body));
+ *     http_reply(body);
+ * }
+ * @endcode
+ */
+#define DECLARE_LOG_RECENT(TAG, DEPTH, LINE_SIZE)                                              \
+                                                                                               \
+typedef struct {                                                                               \
+    volatile uint32_t seq;          /* 2n+1 while record n is written, 2n+2 after */           \
+    volatile uint16_t len;                                                                     \
+    char text[LINE_SIZE];                                                                      \
+} TAG##_log_recent_slot_t;                                                                     \
+                                                                                               \
+static TAG##_log_recent_slot_t TAG##_log_recent_slots[TAG##_LOG_LEVEL_NONE][DEPTH];            \
+static volatile uint32_t TAG##_log_recent_claimed[TAG##_LOG_LEVEL_NONE];                       \
+static volatile uint8_t TAG##_log_recent_level = TAG##_LOG_LEVEL_NONE;                         \
+                                                                                               \
+/* Tap called by the core for every formatted line */                                          \
+static inline void TAG##_log_recent_record(int level, const char* line, size_t len)            \
+{                                                                                              \
+    if ((unsigned)level >= (unsigned)TAG##_LOG_LEVEL_NONE ||                                   \
+        level < (int)TAG##_log_recent_level)                                                   \
+    {                                                                                          \
+        return;                                                                                \
+    }                                                                                          \
+                                                                                               \
+    uint32_t n = LOG_ATOMIC_FETCH_INC(&TAG##_log_recent_claimed[level]);                       \
+    TAG##_log_recent_slot_t* slot = &TAG##_log_recent_slots[level][n % (uint32_t)(DEPTH)];     \
+    if (len > (size_t)(LINE_SIZE)) { len = (size_t)(LINE_SIZE); }                              \
+                                                                                               \
+    slot->seq = 2u * n + 1u;                                                                   \
+    LOG_MEMORY_BARRIER();   /* Readers see the odd number before any new byte */               \
+    memcpy(slot->text, line, len);                                                             \
+    slot->len = (uint16_t)len;                                                                 \
+    LOG_MEMORY_BARRIER();   /* Contents complete before the even number */                     \
+    slot->seq = 2u * n + 2u;                                                                   \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Record lines at this level and above (lower levels are not kept)                     \
+ */                                                                                            \
+static inline void TAG##_log_recent_enable(TAG##_log_level_e level)                            \
+{                                                                                              \
+    TAG##_log_recent_level = (uint8_t)level;                                                   \
+    TAG##_log_state.recent = TAG##_log_recent_record;                                          \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Stop recording; what is already kept stays readable                                  \
+ */                                                                                            \
+static inline void TAG##_log_recent_disable(void)                                              \
+{                                                                                              \
+    TAG##_log_state.recent = NULL;                                                             \
+    TAG##_log_recent_level = TAG##_LOG_LEVEL_NONE;                                             \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Copy the newest lines of one level into out, oldest first                            \
+ * @param level     Level to read                                                              \
+ * @param max_lines Lines wanted (0 = all kept, at most DEPTH)                                 \
+ * @param out       Destination, NUL-terminated on return                                      \
+ * @param out_size  sizeof(out); copying stops at the first line that does not fit             \
+ * @return Number of lines copied                                                              \
+ * @note Safe to call from any thread while others log; never blocks writers.                  \
+ */                                                                                            \
+static inline size_t TAG##_log_recent_snapshot(TAG##_log_level_e level, size_t max_lines,      \
+                                               char* out, size_t out_size)                     \
+{                                                                                              \
+    if (out == NULL || out_size == 0) { return 0; }                                            \
+    out[0] = '\0';                                                                             \
+    if ((unsigned)level >= (unsigned)TAG##_LOG_LEVEL_NONE) { return 0; }                       \
+                                                                                               \
+    uint32_t end = TAG##_log_recent_claimed[level];                                            \
+    uint32_t count = (end < (uint32_t)(DEPTH)) ? end : (uint32_t)(DEPTH);                      \
+    if (max_lines != 0 && max_lines < count) { count = (uint32_t)max_lines; }                  \
+                                                                                               \
+    size_t used = 0;                                                                           \
+    size_t lines = 0;                                                                          \
+    for (uint32_t n = end - count; n != end; n++)                                              \
+    {                                                                                          \
+        const TAG##_log_recent_slot_t* slot =                                                  \
+            &TAG##_log_recent_slots[level][n % (uint32_t)(DEPTH)];                             \
+        uint32_t seq = slot->seq;                                                              \
+        LOG_MEMORY_BARRIER();   /* Read the contents only after the sequence number */         \
+        if (seq != 2u * n + 2u) { continue; }   /* Still being written, or already replaced */ \
+                                                                                               \
+        size_t len = slot->len;                                                                \
+        if (len > out_size - 1u - used) { break; }                                             \
+        memcpy(&out[used], slot->text, len);                                                   \
+        LOG_MEMORY_BARRIER();   /* Finish copying before re-checking */                        \
+        if (slot->seq != seq) { continue; }   /* Overwritten while copying: drop it */         \
+                                                                                               \
+        used += len;                                                                           \
+        lines++;                                                                               \
+    }                                                                                          \
+    out[used] = '\0';                                                                          \
+    return lines;                                                                              \
+}                                                                                              \
+                                                                                               \
+/**                                                                                            \
+ * @brief Lines recorded at a level since start (including overwritten ones)                   \
+ */                                                                                            \
+static inline uint32_t TAG##_log_recent_total(TAG##_log_level_e level)                         \
+{                                                                                              \
+    if ((unsigned)level >= (unsigned)TAG##_LOG_LEVEL_NONE) { return 0; }                       \
+    return TAG##_log_recent_claimed[level];                                                    \
 }
 
 /**
@@ -477,6 +2273,25 @@ static inline void TAG##_LOG_DEBUG(const char* fmt, ...)
  * }
  * @endcode
  * 
+ * @subsection Adaptive_Load_Shedding
+ * @code
+ * DECLARE_LOG(APP, 128, void)
+ *
+ * // Time every callback with the HAL tick. After 4 lines slower than 5 ms the
+ * // effective level rises one step (DEBUG shed, then INFO, then WARNING);
+ * // after 4 lines faster than 1 ms it drops back one step. ERROR is never shed.
+ * APP_set_shed_policy(HAL_GetTick, 5, 1, 4);
+ *
+ * // Or drive it from your own pressure metric (e.g. TX queue fill in %)
+ * APP_set_shed_policy(NULL, 75, 25, 8);
+ * APP_log_shed_feed(queue_count_u8_256(&tx_queue) * 100 / 256);
+ *
+ * const hol_log_shed_t* st = APP_get_shed_stats();
+ * printf("raises=%lu restores=%lu shed DEBUG=%lu\n",
+ *        (unsigned long)st->raises, (unsigned long)st->restores,
+ *        (unsigned long)st->shed_lines[APP_LOG_LEVEL_DEBUG]);
+ * @endcode
+ * 
  * @subsection Compile_Time_Optimization
  * @code
  * // For production builds, disable DEBUG at compile-time
@@ -504,7 +2319,7 @@ static inline void TAG##_LOG_DEBUG(const char* fmt, ...)
  * 
  * When log actually prints:
  * - Overhead: 50-80 µs (formatting + callback)
- * - Stack: ~384 bytes (default config)
+ * - Stack: ~MAX_LENGTH + 64 bytes plus vsnprintf (default config)
  */
 
 /**
@@ -0,0 +1,503 @@
+/**
+ * @file HOL_Metrics.h
+ * @brief Prometheus text exporter for HOL_Queue and HOL_Logger instances
+ *
+ * @section Features
+ * - Opt-in registry: queues and log TAGs register once at init
+ * - One registry per program (weak symbols on GCC/Clang), whichever file renders
+ *   (all files must agree on HOL_METRICS_MAX_QUEUES / HOL_METRICS_MAX_LOGS)
+ * - hol_metrics_render(): Prometheus exposition text from plain counters,
+ *   no locks taken and nothing reset
+ * - Optional POSIX outputs: atomic textfile write (node_exporter textfile
+ *   collector) and a tiny localhost HTTP endpoint
+ * - Zero dynamic memory
+ *
+ * @section Exported_Metrics
+ * Queues (label queue="name"):
+ * - hol_queue_items, hol_queue_capacity                          gauge
+ * - hol_queue_pushes_total, hol_queue_pulls_total,
+ *   hol_queue_drops_total, hol_queue_overwrites_total             counter (QUEUE_ENABLE_STATS)
+ * - hol_queue_high_water                                          gauge   (QUEUE_ENABLE_STATS)
+ *
+ * Loggers (label tag="TAG"):
+ * - hol_log_lines_total{level}, hol_log_shed_total{level}         counter
+ * - hol_log_truncated_total                                       counter
+ * - hol_log_level_threshold, hol_log_enabled                      gauge
+ *
+ * @section Usage_Example
+ * @code
+ * #define QUEUE_ENABLE_STATS 1
+ * #include "HOL_Metrics.h"
+ *
+ * DECLARE_QUEUE(u8, 64)
+ * DECLARE_LOG(APP, 128, void)
+ * static queue_u8_64_t rx_queue;
+ *
+ * int main(void) {
+ *     queue_initialize_u8_64(&rx_queue);
+ *     HOL_METRICS_REGISTER_QUEUE("rx", &rx_queue, 64);
+ *     HOL_METRICS_REGISTER_LOG(APP);
+ *
+ *     int fd = hol_metrics_http_listen(9464);   // http://127.0.0.1:9464/metrics
+ *     for (;;) {
+ *         hol_metrics_http_poll(fd, 100);       // Or from a dedicated thread
+ *         ...
+ *     }
+ * }
+ * @endcode
+ *
+ * @warning Register at startup, before rendering from another thread.
+ *          Values are read without locks: a scrape may see a counter that
+ *          is one operation behind another, never a torn value.
+ */
+
+#ifndef HOL_METRICS_H
+#define HOL_METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../Queue/HOL_Queue.h"
+#include "../Logger/HOL_Logger.h"
+
+/**
+ * @brief Registry capacity (entries; registration fails when full)
+ */
+#ifndef HOL_METRICS_MAX_QUEUES
+#define HOL_METRICS_MAX_QUEUES 32
+#endif
+
+#ifndef HOL_METRICS_MAX_LOGS
+#define HOL_METRICS_MAX_LOGS 32
+#endif
+
+/**
+ * @brief Render buffer used by the file and HTTP outputs (bytes)
+ * @note Default fits a full registry with label values up to 32 characters
+ *       and maximal counter values (~640 bytes per queue, ~960 per TAG).
+ */
+#ifndef HOL_METRICS_RENDER_SIZE
+#define HOL_METRICS_RENDER_SIZE (2048 + HOL_METRICS_MAX_QUEUES * 640 + HOL_METRICS_MAX_LOGS * 960)
+#endif
+
+/**
+ * @brief Build the POSIX file and HTTP outputs (default: on Unix hosts)
+ */
+#ifndef HOL_METRICS_POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#define HOL_METRICS_POSIX 1
+#else
+#define HOL_METRICS_POSIX 0
+#endif
+#endif
+
+/**
+ * @brief One registry shared by all translation units
+ * @note Weak definitions are merged by the linker; other compilers get one
+ *       registry per translation unit (register and render from the same file).
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define HOL_METRICS_SHARED __attribute__((weak))
+#else
+#define HOL_METRICS_SHARED static
+#endif
+
+/**
+ * @brief Registry symbol name carries its capacities
+ * @note Files built with other HOL_METRICS_MAX_QUEUES / HOL_METRICS_MAX_LOGS
+ *       values get a registry of their own (e.g. hol_metrics_registry_q32_l32)
+ *       instead of a differently sized one. Use the same values, as plain
+ *       decimal literals, in every file that registers or renders.
+ */
+#define HOL_METRICS_REGISTRY_NAME_(q, l) hol_metrics_registry_q##q##_l##l
+#define HOL_METRICS_REGISTRY_NAME(q, l)  HOL_METRICS_REGISTRY_NAME_(q, l)
+#define hol_metrics_registry HOL_METRICS_REGISTRY_NAME(HOL_METRICS_MAX_QUEUES, HOL_METRICS_MAX_LOGS)
+
+/**
+ * @brief Registered queue (type-erased view of a queue_TYPE_SIZE_t)
+ */
+typedef struct {
+    const char*            name;
+    const volatile size_t* count;     /* &queue->count */
+    size_t                 capacity;
+    const queue_stats_t*   stats;     /* NULL without QUEUE_ENABLE_STATS */
+} hol_metrics_queue_t;
+
+typedef struct {
+    hol_metrics_queue_t    queues[HOL_METRICS_MAX_QUEUES];
+    const hol_log_state_t* logs[HOL_METRICS_MAX_LOGS];
+    size_t                 queue_count;
+    size_t                 log_count;
+} hol_metrics_registry_t;
+
+HOL_METRICS_SHARED hol_metrics_registry_t hol_metrics_registry;
+
+/**
+ * @brief Register a queue
+ * @param name     Label value (must stay valid)
+ * @param count    Address of the queue's count field
+ * @param capacity Queue SIZE
+ * @param stats    queue_get_stats_TYPE_SIZE(queue) (may be NULL)
+ * @return false if the registry is full
+ */
+static inline bool hol_metrics_add_queue(const char* name, const volatile size_t* count,
+                                         size_t capacity, const queue_stats_t* stats)
+{
+    hol_metrics_registry_t* registry = &hol_metrics_registry;
+    if (registry->queue_count >= HOL_METRICS_MAX_QUEUES) { return false; }
+
+    hol_metrics_queue_t* entry = &registry->queues[registry->queue_count];
+    entry->name = name;
+    entry->count = count;
+    entry->capacity = capacity;
+    entry->stats = stats;
+    registry->queue_count++;
+    return true;
+}
+
+/**
+ * @brief Register a log TAG's state
+ * @return false if the registry is full
+ */
+static inline bool hol_metrics_add_log(const hol_log_state_t* state)
+{
+    hol_metrics_registry_t* registry = &hol_metrics_registry;
+    if (registry->log_count >= HOL_METRICS_MAX_LOGS) { return false; }
+    registry->logs[registry->log_count++] = state;
+    return true;
+}
+
+/**
+ * @brief Register a queue declared with DECLARE_QUEUE(TYPE, SIZE)
+ * @param name  Label value, e.g. "rx"
+ * @param queue Pointer to the queue
+ * @param SIZE  Queue capacity
+ */
+#define HOL_METRICS_REGISTER_QUEUE(name, queue, SIZE) \
+    hol_metrics_add_queue((name), &(queue)->count, (SIZE), QUEUE_STATS_OF(queue))
+
+/**
+ * @brief Register a TAG declared with DECLARE_LOG (same file as the declaration)
+ */
+#define HOL_METRICS_REGISTER_LOG(TAG) hol_metrics_add_log(&TAG##_log_state)
+
+/* Bounded text writer: keeps counting past the end like snprintf */
+typedef struct {
+    char*  out;
+    size_t cap;
+    size_t len;
+} hol_metrics_writer_t;
+
+static inline void hol_metrics_put(hol_metrics_writer_t* w, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    size_t room = (w->len < w->cap) ? w->cap - w->len : 0;
+    int n = vsnprintf((room != 0) ? &w->out[w->len] : NULL, room, fmt, args);
+    va_end(args);
+    if (n > 0) { w->len += (size_t)n; }
+}
+
+/* Label value with Prometheus escaping (\\, \", \n) */
+static inline void hol_metrics_put_label(hol_metrics_writer_t* w, const char* value)
+{
+    for (const char* p = value; *p != '\0'; p++)
+    {
+        if (*p == '\\')      { hol_metrics_put(w, "\\\\"); }
+        else if (*p == '"')  { hol_metrics_put(w, "\\\""); }
+        else if (*p == '\n') { hol_metrics_put(w, "\\n"); }
+        else                 { hol_metrics_put(w, "%c", *p); }
+    }
+}
+
+static inline void hol_metrics_put_family(hol_metrics_writer_t* w, const char* name,
+                                          const char* type, const char* help)
+{
+    hol_metrics_put(w, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+/* Queue metrics selected by field: 0 items, 1 capacity, 2-5 counters, 6 high water */
+static inline bool hol_metrics_queue_value(const hol_metrics_queue_t* q, int field,
+                                           unsigned long long* value)
+{
+    const queue_stats_t* s = q->stats;
+    switch (field)
+    {
+        case 0: *value = *q->count; return true;
+        case 1: *value = q->capacity; return true;
+        default: break;
+    }
+    if (s == NULL) { return false; }
+    switch (field)
+    {
+        case 2:  *value = s->pushes; break;
+        case 3:  *value = s->pulls; break;
+        case 4:  *value = s->drops; break;
+        case 5:  *value = s->overwrites; break;
+        default: *value = s->high_water; break;
+    }
+    return true;
+}
+
+/**
+ * @brief Render all registered metrics as Prometheus exposition text
+ * @param out Destination (NUL-terminated when cap > 0)
+ * @param cap sizeof(out)
+ * @return Length of the full text; >= cap means out was too small (like snprintf)
+ */
+static inline size_t hol_metrics_render(char* out, size_t cap)
+{
+    static const struct { const char* name; const char* type; const char* help; } queue_families[] = {
+        { "hol_queue_items",            "gauge",   "Items currently queued" },
+        { "hol_queue_capacity",         "gauge",   "Queue capacity" },
+        { "hol_queue_pushes_total",     "counter", "Items pushed" },
+        { "hol_queue_pulls_total",      "counter", "Items pulled" },
+        { "hol_queue_drops_total",      "counter", "Pushes rejected because the queue was full" },
+        { "hol_queue_overwrites_total", "counter", "Oldest items overwritten because the queue was full" },
+        { "hol_queue_high_water",       "gauge",   "Highest number of items queued" },
+    };
+    static const char* const level_names[4] = { "debug", "info", "warning", "error" };
+
+    const hol_metrics_registry_t* registry = &hol_metrics_registry;
+    hol_metrics_writer_t w = { out, cap, 0 };
+    if (cap != 0) { out[0] = '\0'; }
+
+    for (int field = 0; field < (int)(sizeof(queue_families) / sizeof(queue_families[0])); field++)
+    {
+        bool header = false;
+        for (size_t i = 0; i < registry->queue_count; i++)
+        {
+            unsigned long long value;
+            if (!hol_metrics_queue_value(&registry->queues[i], field, &value)) { continue; }
+            if (!header)
+            {
+                hol_metrics_put_family(&w, queue_families[field].name, queue_families[field].type,
+                                       queue_families[field].help);
+                header = true;
+            }
+            hol_metrics_put(&w, "%s{queue=\"", queue_families[field].name);
+            hol_metrics_put_label(&w, registry->queues[i].name);
+            hol_metrics_put(&w, "\"} %llu\n", value);
+        }
+    }
+
+    if (registry->log_count != 0)
+    {
+        hol_metrics_put_family(&w, "hol_log_lines_total", "counter", "Log lines produced per level");
+        for (size_t i = 0; i < registry->log_count; i++)
+        {
+            for (int level = 0; level < 4; level++)
+            {
+                hol_metrics_put(&w, "hol_log_lines_total{tag=\"%s\",level=\"%s\"} %lu\n",
+                                registry->logs[i]->tag, level_names[level],
+                                (unsigned long)registry->logs[i]->lines[level]);
+            }
+        }
+
+        hol_metrics_put_family(&w, "hol_log_shed_total", "counter", "Log lines dropped by load shedding");
+        for (size_t i = 0; i < registry->log_count; i++)
+        {
+            for (int level = 0; level < LOG_SHED_MAX_FLOOR; level++)
+            {
+                hol_metrics_put(&w, "hol_log_shed_total{tag=\"%s\",level=\"%s\"} %lu\n",
+                                registry->logs[i]->tag, level_names[level],
+                                (unsigned long)registry->logs[i]->shed.shed_lines[level]);
+            }
+        }
+
+        hol_metrics_put_family(&w, "hol_log_truncated_total", "counter", "Log messages cut to fit the line");
+        for (size_t i = 0; i < registry->log_count; i++)
+        {
+            hol_metrics_put(&w, "hol_log_truncated_total{tag=\"%s\"} %lu\n", registry->logs[i]->tag,
+                            (unsigned long)registry->logs[i]->truncated);
+        }
+
+        hol_metrics_put_family(&w, "hol_log_level_threshold", "gauge",
+                               "Effective minimum level (0 debug .. 3 error, 4 none)");
+        for (size_t i = 0; i < registry->log_count; i++)
+        {
+            hol_metrics_put(&w, "hol_log_level_threshold{tag=\"%s\"} %u\n", registry->logs[i]->tag,
+                            (unsigned)registry->logs[i]->threshold);
+        }
+
+        hol_metrics_put_family(&w, "hol_log_enabled", "gauge", "1 if the TAG is enabled");
+        for (size_t i = 0; i < registry->log_count; i++)
+        {
+            hol_metrics_put(&w, "hol_log_enabled{tag=\"%s\"} %d\n", registry->logs[i]->tag,
+                            registry->logs[i]->enabled ? 1 : 0);
+        }
+    }
+    return w.len;
+}
+
+#if HOL_METRICS_POSIX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/* Linux: no SIGPIPE per send(); macOS sets SO_NOSIGPIPE on the socket instead */
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/* write() the whole range, retrying on EINTR and short writes */
+static inline bool hol_metrics_write_all(int fd, const char* data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* send() the whole range without raising SIGPIPE; false with errno EPIPE
+ * or ECONNRESET when the peer has gone away */
+static inline bool hol_metrics_send_all(int fd, const char* data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Render into path atomically (write path.tmp, then rename)
+ * @note Point node_exporter's textfile collector at a "*.prom" path and call
+ *       this periodically (e.g. every 10 s); readers never see a partial file.
+ * @return 0 on success, -1 on error (errno set; EMSGSIZE: HOL_METRICS_RENDER_SIZE too small)
+ */
+static inline int hol_metrics_write_file(const char* path)
+{
+    static char text[HOL_METRICS_RENDER_SIZE];
+    char tmp[512];
+    size_t len = hol_metrics_render(text, sizeof(text));
+    if (len >= sizeof(text))
+    {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) { return -1; }
+    bool ok = hol_metrics_write_all(fd, text, len);
+    ok = (close(fd) == 0) && ok;
+    if (!ok || rename(tmp, path) != 0)
+    {
+        (void)unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Open a listening socket on 127.0.0.1:port for hol_metrics_http_poll()
+ * @return Listening fd, or -1 on error (errno set)
+ */
+static inline int hol_metrics_http_listen(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) { return -1; }
+
+    int one = 1;
+    (void)setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 4) != 0)
+    {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Answer at most one scrape: wait up to timeout_ms for a connection
+ * @param listen_fd  Socket from hol_metrics_http_listen()
+ * @param timeout_ms poll() timeout (0 = just check, -1 = wait)
+ * @return 1 if a request was answered, 0 on timeout, -1 on error
+ *
+ * Every request path gets the metrics (HTTP/1.0, connection closed after
+ * the reply). A client that disconnects early never raises SIGPIPE. Meant for a monitoring thread or an idle loop, not for
+ * untrusted networks: it only listens on localhost.
+ */
+static inline int hol_metrics_http_poll(int listen_fd, int timeout_ms)
+{
+    static char text[HOL_METRICS_RENDER_SIZE];
+    struct pollfd pfd = { listen_fd, POLLIN, 0 };
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) { return (ready == 0 || errno == EINTR) ? 0 : -1; }
+
+    int client = accept(listen_fd, NULL, NULL);
+    if (client < 0) { return (errno == EAGAIN || errno == EINTR) ? 0 : -1; }
+#if defined(SO_NOSIGPIPE)
+    int one = 1;
+    (void)setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    /* Read the request head (bounded wait); its content does not matter */
+    char request[1024];
+    struct pollfd cfd = { client, POLLIN, 0 };
+    if (poll(&cfd, 1, 1000) > 0) { (void)read(client, request, sizeof(request)); }
+
+    size_t len = hol_metrics_render(text, sizeof(text));
+    const char* status = "200 OK";
+    if (len >= sizeof(text))
+    {
+        /* A cut exposition would be rejected by the scraper: say why instead */
+        status = "500 Internal Server Error";
+        len = (size_t)snprintf(text, sizeof(text), "HOL_METRICS_RENDER_SIZE too small (%zu needed)\n", len);
+    }
+
+    char head[160];
+    int head_len = snprintf(head, sizeof(head),
+                            "HTTP/1.0 %s\r\n"
+                            "Content-Type: text/plain; version=0.0.4\r\n"
+                            "Content-Length: %zu\r\n"
+                            "Connection: close\r\n\r\n", status, len);
+    bool ok = hol_metrics_send_all(client, head, (size_t)head_len) &&
+              hol_metrics_send_all(client, text, len);
+
+    /* A scraper that hangs up early is a normal disconnect, not an error */
+    if (!ok && (errno == EPIPE || errno == ECONNRESET)) { ok = true; }
+    close(client);
+    return ok ? 1 : -1;
+}
+
+#endif /* HOL_METRICS_POSIX */
+
+#endif /* HOL_METRICS_H */
@@ -0,0 +1,714 @@
+/**
+ * @file HOL_Pipeline.h
+ * @brief Typed multi-stage pipelines on lock-free SPSC rings (POSIX threads)
+ *
+ * @section Features
+ * - Typed stages: a source, any number of transform stages and a sink, each
+ *   generated by a macro for its input / output item types
+ * - Links are DECLARE_SPSC_QUEUE rings: one thread writes, one reads, no locks
+ * - Batches, not items: a stage receives up to BATCH items, its function
+ *   handles them in one call, and the results are published with one index
+ *   update
+ * - Idle stages spin (CPU pause), then yield, then park on a condition
+ *   variable; the upstream stage wakes them only if they actually parked
+ * - Optional CPU pinning per stage (Linux)
+ * - Per-stage utilisation: busy / idle (starved) / stall (downstream full),
+ *   so the bottleneck is the stage that is busy while the others wait
+ * - End of stream propagates: a source returning HOL_PIPELINE_END closes its
+ *   link, every stage drains its input and closes the next one
+ *
+ * @section Usage_Example
+ * @code
+ * #define _GNU_SOURCE                  // CPU pinning on Linux (before any include)
+ * #include "HOL_Pipeline.h"
+ *
+ * typedef struct { char text[120]; } line_t;
+ * typedef struct { uint32_t id; int32_t value; } record_t;
+ *
+ * DECLARE_PIPELINE_LINK(line_t, 1024)
+ * DECLARE_PIPELINE_LINK(record_t, 1024)
+ * DECLARE_PIPELINE_SOURCE(reader, line_t, 1024, 64)
+ * DECLARE_PIPELINE_STAGE(parser, line_t, 1024, record_t, 1024, 64)
+ * DECLARE_PIPELINE_SINK(writer, record_t, 1024, 64)
+ *
+ * static size_t read_lines(void* ctx, line_t* out, size_t max);          // HOL_PIPELINE_END at EOF
+ * static size_t parse(void* ctx, const line_t* in, size_t n, record_t* out);
+ * static void   write_records(void* ctx, const record_t* in, size_t n);
+ *
+ * static hol_pipeline_t pipeline;
+ * static pipeline_link_line_t_1024_t lines;
+ * static pipeline_link_record_t_1024_t records;
+ * static reader_stage_t reader;
+ * static parser_stage_t parser;
+ * static writer_stage_t writer;
+ *
+ * int main(void) {
+ *     hol_pipeline_init(&pipeline);
+ *     pipeline_link_init_line_t_1024(&lines);
+ *     pipeline_link_init_record_t_1024(&records);
+ *     reader_stage_add(&pipeline, &reader, read_lines, NULL, &lines, 0);        // CPU 0
+ *     parser_stage_add(&pipeline, &parser, parse, NULL, &lines, &records, 1);  // CPU 1
+ *     writer_stage_add(&pipeline, &writer, write_records, NULL, &records, 2);  // CPU 2
+ *     hol_pipeline_start(&pipeline);
+ *     hol_pipeline_join(&pipeline);             // Returns after the sink drained everything
+ *     hol_pipeline_report(&pipeline, stdout);
+ * }
+ * @endcode
+ *
+ * @warning POSIX hosts (pthreads). Each link connects exactly one stage to
+ *          the next; fan-in / fan-out needs one link per pair.
+ */
+
+#ifndef HOL_PIPELINE_H
+#define HOL_PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "../Queue/HOL_Queue.h"
+
+/* ==================== CONFIGURATION ==================== */
+
+/**
+ * @brief Stages per pipeline (hol_pipeline_t holds pointers only)
+ */
+#ifndef HOL_PIPELINE_MAX_STAGES
+#define HOL_PIPELINE_MAX_STAGES 16
+#endif
+
+/**
+ * @brief Idle strategy: empty polls with a CPU pause, then sched_yield() rounds, then park
+ * @note Spinning keeps hand-off latency at a few hundred ns while items flow;
+ *       parking releases the core once a stage has been idle for a while.
+ */
+#ifndef HOL_PIPELINE_SPIN
+#define HOL_PIPELINE_SPIN 256
+#endif
+
+#ifndef HOL_PIPELINE_YIELD
+#define HOL_PIPELINE_YIELD 16
+#endif
+
+/**
+ * @brief Longest single park (us); a wake-up from the neighbour ends it earlier
+ */
+#ifndef HOL_PIPELINE_PARK_US
+#define HOL_PIPELINE_PARK_US 1000
+#endif
+
+/**
+ * @brief CPU hint inside spin loops
+ */
+#ifndef HOL_PIPELINE_CPU_RELAX
+#if defined(__x86_64__) || defined(__i386__)
+#define HOL_PIPELINE_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define HOL_PIPELINE_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+#define HOL_PIPELINE_CPU_RELAX() do { } while (0)
+#endif
+#endif
+
+/**
+ * @brief Returned by a source function when the stream has ended
+ */
+#define HOL_PIPELINE_END ((size_t)-1)
+
+/* Counters have one writer (the stage thread) and are read by hol_pipeline_report() */
+#define HOL_PIPELINE_STAT_ADD(stage, field, n)                                                     \
+    __atomic_store_n(&(stage)->stats.field, (stage)->stats.field + (uint64_t)(n), __ATOMIC_RELAXED)
+#define HOL_PIPELINE_STAT_GET(stage, field) __atomic_load_n(&(stage)->stats.field, __ATOMIC_RELAXED)
+
+/* ==================== RUNTIME ==================== */
+
+/**
+ * @brief Park / wake state of one link (untyped part)
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    int             consumer_parked;          /* Reader sleeps: ring was empty */
+    int             producer_parked;          /* Writer sleeps: ring was full */
+    int             closed;                   /* Writer finished: drain, then stop */
+} hol_pipeline_signal_t;
+
+/**
+ * @brief Per-stage counters (nanoseconds and items)
+ */
+typedef struct {
+    uint64_t items_in;
+    uint64_t items_out;
+    uint64_t batches;                         /* Calls of the stage function with work */
+    uint64_t busy_ns;                         /* In the stage function and publishing */
+    uint64_t idle_ns;                         /* Waiting for input (starved) */
+    uint64_t stall_ns;                        /* Waiting for room downstream (backpressure) */
+    uint64_t parks;                           /* Times the thread went to sleep */
+    uint64_t start_ns;
+    uint64_t end_ns;                          /* 0 while running */
+} hol_pipeline_stats_t;
+
+typedef struct hol_pipeline hol_pipeline_t;
+
+/**
+ * @brief Untyped stage header; first member of every generated NAME_stage_t
+ */
+typedef struct {
+    const char*      name;
+    int              cpu;                     /* -1 = not pinned */
+    bool             pinned;                  /* Affinity was applied */
+    hol_pipeline_t*  pipeline;
+    void*          (*main)(void* stage);
+    hol_pipeline_signal_t* signals[2];        /* Input / output link, woken on abort */
+    pthread_t        thread;
+    hol_pipeline_stats_t stats;
+} hol_pipeline_stage_t;
+
+struct hol_pipeline {
+    hol_pipeline_stage_t* stages[HOL_PIPELINE_MAX_STAGES];
+    size_t   count;
+    size_t   started;
+    int      stop;                            /* hol_pipeline_request_stop() */
+    int      aborted;                         /* Start failed: exit without draining */
+};
+
+static inline uint64_t hol_pipeline_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline void hol_pipeline_signal_init(hol_pipeline_signal_t* signal)
+{
+    pthread_mutex_init(&signal->lock, NULL);
+    pthread_cond_init(&signal->cond, NULL);
+    signal->consumer_parked = 0;
+    signal->producer_parked = 0;
+    signal->closed = 0;
+}
+
+/* Wake the other side if it parked; called after publishing an index */
+static inline void hol_pipeline_wake(hol_pipeline_signal_t* signal, int* parked)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);  /* Index store before the parked load */
+    if (__atomic_load_n(parked, __ATOMIC_RELAXED))
+    {
+        pthread_mutex_lock(&signal->lock);
+        pthread_cond_broadcast(&signal->cond);
+        pthread_mutex_unlock(&signal->lock);
+    }
+}
+
+static inline bool hol_pipeline_aborting(const hol_pipeline_stage_t* stage)
+{
+    return __atomic_load_n(&stage->pipeline->aborted, __ATOMIC_ACQUIRE) != 0;
+}
+
+/**
+ * @brief One idle round: spin, yield or park depending on how long the stage waited
+ * @param blocked Re-checked after announcing the park, so a hand-off that
+ *                raced with it is never slept through (NULL: timed sleep)
+ */
+static inline void hol_pipeline_backoff(hol_pipeline_stage_t* stage, hol_pipeline_signal_t* signal,
+                                        int* parked, unsigned* round,
+                                        bool (*blocked)(void* link), void* link)
+{
+    unsigned r = (*round)++;
+    if (r < HOL_PIPELINE_SPIN) { HOL_PIPELINE_CPU_RELAX(); return; }
+    if (r < HOL_PIPELINE_SPIN + HOL_PIPELINE_YIELD) { sched_yield(); return; }
+
+    HOL_PIPELINE_STAT_ADD(stage, parks, 1);
+    if (signal == NULL)
+    {
+        struct timespec pause = { 0, HOL_PIPELINE_PARK_US * 1000L };
+        nanosleep(&pause, NULL);
+        return;
+    }
+
+    pthread_mutex_lock(&signal->lock);
+    __atomic_store_n(parked, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);  /* parked store before the index load */
+    if (!hol_pipeline_aborting(stage) && blocked(link))
+    {
+        struct timespec until;
+        clock_gettime(CLOCK_REALTIME, &until);
+        until.tv_nsec += HOL_PIPELINE_PARK_US * 1000L;
+        if (until.tv_nsec >= 1000000000L) { until.tv_sec++; until.tv_nsec -= 1000000000L; }
+        (void)pthread_cond_timedwait(&signal->cond, &signal->lock, &until);
+    }
+    __atomic_store_n(parked, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&signal->lock);
+}
+
+/* Stage thread prologue / epilogue */
+static inline void hol_pipeline_stage_begin(hol_pipeline_stage_t* stage)
+{
+#if defined(__linux__) && defined(CPU_SET)
+    if (stage->cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(stage->cpu, &set);
+        stage->pinned = (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0);
+    }
+#endif
+    __atomic_store_n(&stage->stats.start_ns, hol_pipeline_now_ns(), __ATOMIC_RELAXED);
+}
+
+static inline void hol_pipeline_stage_end(hol_pipeline_stage_t* stage)
+{
+    __atomic_store_n(&stage->stats.end_ns, hol_pipeline_now_ns(), __ATOMIC_RELAXED);
+}
+
+static inline bool hol_pipeline_stopping(const hol_pipeline_stage_t* stage)
+{
+    return __atomic_load_n(&stage->pipeline->stop, __ATOMIC_RELAXED) != 0;
+}
+
+/**
+ * @brief Register a stage (done by the generated NAME_stage_add())
+ * @return false if the pipeline is full or already started
+ */
+static inline bool hol_pipeline_add(hol_pipeline_t* pipeline, hol_pipeline_stage_t* stage,
+                                    const char* name, void* (*main)(void*), int cpu)
+{
+    if (pipeline->count >= HOL_PIPELINE_MAX_STAGES || pipeline->started != 0) { return false; }
+    memset(stage, 0, sizeof(*stage));
+    stage->name = name;
+    stage->cpu = cpu;
+    stage->pipeline = pipeline;
+    stage->main = main;
+    pipeline->stages[pipeline->count++] = stage;
+    return true;
+}
+
+/**
+ * @brief Prepare an empty pipeline
+ */
+static inline void hol_pipeline_init(hol_pipeline_t* pipeline)
+{
+    memset(pipeline, 0, sizeof(*pipeline));
+}
+
+/**
+ * @brief Wait for every started stage thread to finish
+ */
+static inline void hol_pipeline_join(hol_pipeline_t* pipeline)
+{
+    for (size_t i = 0; i < pipeline->started; i++)
+    {
+        pthread_join(pipeline->stages[i]->thread, NULL);
+    }
+    pipeline->started = 0;
+}
+
+/* Make every stage return from send / receive at once and wake the parked ones */
+static inline void hol_pipeline_abort(hol_pipeline_t* pipeline)
+{
+    __atomic_store_n(&pipeline->stop, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&pipeline->aborted, 1, __ATOMIC_RELEASE);
+    for (size_t i = 0; i < pipeline->count; i++)
+    {
+        for (size_t j = 0; j < 2; j++)
+        {
+            hol_pipeline_signal_t* signal = pipeline->stages[i]->signals[j];
+            if (signal == NULL) { continue; }
+            pthread_mutex_lock(&signal->lock);
+            pthread_cond_broadcast(&signal->cond);
+            pthread_mutex_unlock(&signal->lock);
+        }
+    }
+}
+
+/**
+ * @brief Start one thread per registered stage
+ * @return 0 on success, else the pthread_create() error. Stages started before
+ *         the failure are stopped without draining and joined first; the
+ *         pipeline must be initialised again before another start.
+ */
+static inline int hol_pipeline_start(hol_pipeline_t* pipeline)
+{
+    for (size_t i = 0; i < pipeline->count; i++)
+    {
+        hol_pipeline_stage_t* stage = pipeline->stages[i];
+        int err = pthread_create(&stage->thread, NULL, stage->main, stage);
+        if (err != 0)
+        {
+            /* Started stages may wait on a link whose other end never runs */
+            hol_pipeline_abort(pipeline);
+            hol_pipeline_join(pipeline);
+            return err;
+        }
+        pipeline->started = i + 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Ask the sources to end the stream; the other stages drain and exit
+ */
+static inline void hol_pipeline_request_stop(hol_pipeline_t* pipeline)
+{
+    __atomic_store_n(&pipeline->stop, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Fraction of the stage's lifetime spent working (0..1)
+ */
+static inline double hol_pipeline_utilisation(const hol_pipeline_stage_t* stage)
+{
+    uint64_t start = HOL_PIPELINE_STAT_GET(stage, start_ns);
+    uint64_t end = HOL_PIPELINE_STAT_GET(stage, end_ns);
+    if (start == 0) { return 0.0; }
+    if (end == 0) { end = hol_pipeline_now_ns(); }
+    return (end > start) ? (double)HOL_PIPELINE_STAT_GET(stage, busy_ns) / (double)(end - start)
+                         : 0.0;
+}
+
+/**
+ * @brief Print per-stage counters and utilisation; safe while the pipeline runs
+ *
+ * busy  : in the stage function and publishing its output
+ * idle  : waiting for input (the stage is faster than what feeds it)
+ * stall : waiting for room downstream (a later stage is the bottleneck)
+ * The busiest stage is marked as the bottleneck.
+ */
+static inline void hol_pipeline_report(const hol_pipeline_t* pipeline, FILE* out)
+{
+    size_t busiest = 0;
+    for (size_t i = 1; i < pipeline->count; i++)
+    {
+        if (hol_pipeline_utilisation(pipeline->stages[i]) >
+            hol_pipeline_utilisation(pipeline->stages[busiest])) { busiest = i; }
+    }
+
+    fprintf(out, "%-16s %4s %12s %12s %10s %7s %6s %6s %6s %8s\n", "stage", "cpu", "items in",
+            "items out", "batches", "avg", "busy%", "idle%", "stall%", "parks");
+    for (size_t i = 0; i < pipeline->count; i++)
+    {
+        const hol_pipeline_stage_t* stage = pipeline->stages[i];
+        uint64_t start = HOL_PIPELINE_STAT_GET(stage, start_ns);
+        uint64_t end = HOL_PIPELINE_STAT_GET(stage, end_ns);
+        if (end == 0) { end = hol_pipeline_now_ns(); }
+        double life = (start != 0 && end > start) ? (double)(end - start) : 1.0;
+        uint64_t batches = HOL_PIPELINE_STAT_GET(stage, batches);
+        uint64_t items = HOL_PIPELINE_STAT_GET(stage, items_in);
+        if (items == 0) { items = HOL_PIPELINE_STAT_GET(stage, items_out); }   /* Source */
+
+        char cpu[16];
+        if (stage->cpu < 0) { snprintf(cpu, sizeof(cpu), "-"); }
+        else { snprintf(cpu, sizeof(cpu), "%d%s", stage->cpu, stage->pinned ? "" : "?"); }
+
+        fprintf(out, "%-16s %4s %12llu %12llu %10llu %7.1f %6.1f %6.1f %6.1f %8llu%s\n",
+                stage->name, cpu,
+                (unsigned long long)HOL_PIPELINE_STAT_GET(stage, items_in),
+                (unsigned long long)HOL_PIPELINE_STAT_GET(stage, items_out),
+                (unsigned long long)batches, batches ? (double)items / (double)batches : 0.0,
+                100.0 * (double)HOL_PIPELINE_STAT_GET(stage, busy_ns) / life,
+                100.0 * (double)HOL_PIPELINE_STAT_GET(stage, idle_ns) / life,
+                100.0 * (double)HOL_PIPELINE_STAT_GET(stage, stall_ns) / life,
+                (unsigned long long)HOL_PIPELINE_STAT_GET(stage, parks),
+                (i == busiest && pipeline->count > 1) ? "  <- bottleneck" : "");
+    }
+}
+
+/* ==================== TYPED LINKS ==================== */
+
+/**
+ * @brief Declare a link type: an SPSC ring of TYPE plus its park / wake state
+ * @param TYPE Item type carried between two stages
+ * @param SIZE Ring capacity (power of two recommended)
+ *
+ * Generates pipeline_link_TYPE_SIZE_t and pipeline_link_init_TYPE_SIZE().
+ * Also declares spsc_queue_TYPE_SIZE_t: do not repeat DECLARE_SPSC_QUEUE(TYPE, SIZE).
+ */
+#define DECLARE_PIPELINE_LINK(TYPE, SIZE)                                                          \
+                                                                                                   \
+DECLARE_SPSC_QUEUE(TYPE, SIZE)                                                                     \
+                                                                                                   \
+typedef struct {                                                                                   \
+    spsc_queue_##TYPE##_##SIZE##_t ring;                                                           \
+    hol_pipeline_signal_t signal;                                                                  \
+} pipeline_link_##TYPE##_##SIZE##_t;                                                               \
+                                                                                                   \
+static inline void pipeline_link_init_##TYPE##_##SIZE(pipeline_link_##TYPE##_##SIZE##_t* link)     \
+{                                                                                                  \
+    spsc_queue_initialize_##TYPE##_##SIZE(&link->ring);                                            \
+    hol_pipeline_signal_init(&link->signal);                                                       \
+}                                                                                                  \
+                                                                                                   \
+/* Park predicates, evaluated with the park announced */                                           \
+static inline bool pipeline_link_starved_##TYPE##_##SIZE(void* link)                               \
+{                                                                                                  \
+    pipeline_link_##TYPE##_##SIZE##_t* self = (pipeline_link_##TYPE##_##SIZE##_t*)link;            \
+    return spsc_queue_is_empty_##TYPE##_##SIZE(&self->ring) &&                                     \
+           !__atomic_load_n(&self->signal.closed, __ATOMIC_ACQUIRE);                               \
+}                                                                                                  \
+                                                                                                   \
+static inline bool pipeline_link_congested_##TYPE##_##SIZE(void* link)                             \
+{                                                                                                  \
+    pipeline_link_##TYPE##_##SIZE##_t* self = (pipeline_link_##TYPE##_##SIZE##_t*)link;            \
+    return spsc_queue_space_##TYPE##_##SIZE(&self->ring, 1) == 0;                                  \
+}                                                                                                  \
+                                                                                                   \
+/* Producer: publish a whole batch, waiting while the ring is full; returns ns stalled */          \
+static inline uint64_t pipeline_link_send_##TYPE##_##SIZE(pipeline_link_##TYPE##_##SIZE##_t* link, \
+    hol_pipeline_stage_t* stage, const TYPE* items, size_t len)                                    \
+{                                                                                                  \
+    unsigned round = 0;                                                                            \
+    uint64_t stalled_since = 0;                                                                    \
+    while (len > 0)                                                                                \
+    {                                                                                              \
+        size_t sent = spsc_queue_push_batch_##TYPE##_##SIZE(&link->ring, items, len);              \
+        if (sent > 0)                                                                              \
+        {                                                                                          \
+            spsc_queue_flush_##TYPE##_##SIZE(&link->ring);   /* One send = one publication */      \
+            items += sent;                                                                         \
+            len -= sent;                                                                           \
+            round = 0;                                                                             \
+            hol_pipeline_wake(&link->signal, &link->signal.consumer_parked);                       \
+            continue;                                                                              \
+        }                                                                                          \
+        if (hol_pipeline_aborting(stage)) { break; }   /* Start failed: drop the rest */           \
+        if (stalled_since == 0) { stalled_since = hol_pipeline_now_ns(); }                         \
+        hol_pipeline_backoff(stage, &link->signal, &link->signal.producer_parked, &round,          \
+                             pipeline_link_congested_##TYPE##_##SIZE, link);                       \
+    }                                                                                              \
+    if (stalled_since == 0) { return 0; }                                                          \
+    uint64_t stalled = hol_pipeline_now_ns() - stalled_since;                                      \
+    HOL_PIPELINE_STAT_ADD(stage, stall_ns, stalled);                                               \
+    return stalled;                                                                                \
+}                                                                                                  \
+                                                                                                   \
+/* Consumer: take up to max_len items, waiting while the ring is empty; 0 = closed and drained */  \
+static inline size_t pipeline_link_receive_##TYPE##_##SIZE(pipeline_link_##TYPE##_##SIZE##_t* link, \
+    hol_pipeline_stage_t* stage, TYPE* items, size_t max_len)                                      \
+{                                                                                                  \
+    unsigned round = 0;                                                                            \
+    uint64_t idle_since = 0;                                                                       \
+    size_t got = 0;                                                                                \
+    for (;;)                                                                                       \
+    {                                                                                              \
+        got = spsc_queue_pull_batch_##TYPE##_##SIZE(&link->ring, items, max_len);                  \
+        if (got > 0)                                                                               \
+        {                                                                                          \
+            hol_pipeline_wake(&link->signal, &link->signal.producer_parked);                       \
+            break;                                                                                 \
+        }                                                                                          \
+        if (__atomic_load_n(&link->signal.closed, __ATOMIC_ACQUIRE))                               \
+        {                                                                                          \
+            got = spsc_queue_pull_batch_##TYPE##_##SIZE(&link->ring, items, max_len);              \
+            break;                                                                                 \
+        }                                                                                          \
+        if (hol_pipeline_aborting(stage)) { break; }                                               \
+        if (idle_since == 0) { idle_since = hol_pipeline_now_ns(); }                               \
+        hol_pipeline_backoff(stage, &link->signal, &link->signal.consumer_parked, &round,          \
+                             pipeline_link_starved_##TYPE##_##SIZE, link);                         \
+    }                                                                                              \
+    if (idle_since != 0)                                                                           \
+    {                                                                                              \
+        HOL_PIPELINE_STAT_ADD(stage, idle_ns, hol_pipeline_now_ns() - idle_since);                 \
+    }                                                                                              \
+    return got;                                                                                    \
+}                                                                                                  \
+                                                                                                   \
+/* Producer: end of stream (everything sent before stays readable) */                              \
+static inline void pipeline_link_close_##TYPE##_##SIZE(pipeline_link_##TYPE##_##SIZE##_t* link)    \
+{                                                                                                  \
+    __atomic_store_n(&link->signal.closed, 1, __ATOMIC_RELEASE);                                   \
+    pthread_mutex_lock(&link->signal.lock);                                                        \
+    pthread_cond_broadcast(&link->signal.cond);                                                    \
+    pthread_mutex_unlock(&link->signal.lock);                                                      \
+}
+
+/* ==================== TYPED STAGES ==================== */
+
+/**
+ * @brief Declare a source stage: produces OUT_TYPE items into a link
+ * @param NAME     Stage name (prefix of the generated identifiers)
+ * @param OUT_TYPE / OUT_SIZE  Output link, declared with DECLARE_PIPELINE_LINK
+ * @param BATCH    Items requested per call (stack buffer of the stage thread)
+ *
+ * Stage function: size_t fn(void* ctx, OUT_TYPE* out, size_t max)
+ *   returns the items written (0 = nothing yet, HOL_PIPELINE_END = stream over)
+ *
+ * Generates NAME_stage_t and
+ *   NAME_stage_add(pipeline, stage, fn, ctx, out_link, cpu)   cpu -1: not pinned
+ */
+#define DECLARE_PIPELINE_SOURCE(NAME, OUT_TYPE, OUT_SIZE, BATCH)                                   \
+                                                                                                   \
+typedef size_t (*NAME##_stage_fn_t)(void* ctx, OUT_TYPE* out, size_t max);                         \
+                                                                                                   \
+typedef struct {                                                                                   \
+    hol_pipeline_stage_t base;                                                                     \
+    NAME##_stage_fn_t fn;                                                                          \
+    void* ctx;                                                                                     \
+    pipeline_link_##OUT_TYPE##_##OUT_SIZE##_t* out;                                                \
+} NAME##_stage_t;                                                                                  \
+                                                                                                   \
+static void* NAME##_stage_main(void* arg)                                                          \
+{                                                                                                  \
+    NAME##_stage_t* self = (NAME##_stage_t*)arg;                                                   \
+    OUT_TYPE batch[BATCH];                                                                         \
+    unsigned round = 0;                                                                            \
+    hol_pipeline_stage_begin(&self->base);                                                         \
+    while (!hol_pipeline_stopping(&self->base))                                                    \
+    {                                                                                              \
+        uint64_t start = hol_pipeline_now_ns();                                                    \
+        size_t produced = self->fn(self->ctx, batch, BATCH);                                       \
+        if (produced == HOL_PIPELINE_END) { break; }                                               \
+        if (produced == 0)                                                                         \
+        {                                                                                          \
+            hol_pipeline_backoff(&self->base, NULL, NULL, &round, NULL, NULL);                     \
+            HOL_PIPELINE_STAT_ADD(&self->base, idle_ns, hol_pipeline_now_ns() - start);            \
+            continue;                                                                              \
+        }                                                                                          \
+        round = 0;                                                                                 \
+        uint64_t stalled = pipeline_link_send_##OUT_TYPE##_##OUT_SIZE(self->out, &self->base,      \
+                                                                      batch, produced);            \
+        HOL_PIPELINE_STAT_ADD(&self->base, busy_ns, hol_pipeline_now_ns() - start - stalled);      \
+        HOL_PIPELINE_STAT_ADD(&self->base, items_out, produced);                                   \
+        HOL_PIPELINE_STAT_ADD(&self->base, batches, 1);                                            \
+    }                                                                                              \
+    pipeline_link_close_##OUT_TYPE##_##OUT_SIZE(self->out);                                        \
+    hol_pipeline_stage_end(&self->base);                                                           \
+    return NULL;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline bool NAME##_stage_add(hol_pipeline_t* pipeline, NAME##_stage_t* stage,               \
+    NAME##_stage_fn_t fn, void* ctx, pipeline_link_##OUT_TYPE##_##OUT_SIZE##_t* out, int cpu)      \
+{                                                                                                  \
+    if (!hol_pipeline_add(pipeline, &stage->base, #NAME, NAME##_stage_main, cpu)) { return false; } \
+    stage->fn = fn;                                                                                \
+    stage->ctx = ctx;                                                                              \
+    stage->out = out;                                                                              \
+    stage->base.signals[1] = &out->signal;                                                         \
+    return true;                                                                                   \
+}
+
+/**
+ * @brief Declare a transform stage: IN_TYPE batches in, OUT_TYPE batches out
+ * @param NAME     Stage name (prefix of the generated identifiers)
+ * @param IN_TYPE / IN_SIZE    Input link
+ * @param OUT_TYPE / OUT_SIZE  Output link
+ * @param BATCH    Largest input batch, and the room given for output items
+ *
+ * Stage function: size_t fn(void* ctx, const IN_TYPE* in, size_t count, OUT_TYPE* out)
+ *   returns the output items written (0..BATCH; fewer than count filters items)
+ *
+ * Generates NAME_stage_t and
+ *   NAME_stage_add(pipeline, stage, fn, ctx, in_link, out_link, cpu)
+ */
+#define DECLARE_PIPELINE_STAGE(NAME, IN_TYPE, IN_SIZE, OUT_TYPE, OUT_SIZE, BATCH)                  \
+                                                                                                   \
+typedef size_t (*NAME##_stage_fn_t)(void* ctx, const IN_TYPE* in, size_t count, OUT_TYPE* out);    \
+                                                                                                   \
+typedef struct {                                                                                   \
+    hol_pipeline_stage_t base;                                                                     \
+    NAME##_stage_fn_t fn;                                                                          \
+    void* ctx;                                                                                     \
+    pipeline_link_##IN_TYPE##_##IN_SIZE##_t* in;                                                   \
+    pipeline_link_##OUT_TYPE##_##OUT_SIZE##_t* out;                                                \
+} NAME##_stage_t;                                                                                  \
+                                                                                                   \
+static void* NAME##_stage_main(void* arg)                                                          \
+{                                                                                                  \
+    NAME##_stage_t* self = (NAME##_stage_t*)arg;                                                   \
+    IN_TYPE input[BATCH];                                                                          \
+    OUT_TYPE output[BATCH];                                                                        \
+    hol_pipeline_stage_begin(&self->base);                                                         \
+    for (;;)                                                                                       \
+    {                                                                                              \
+        size_t count = pipeline_link_receive_##IN_TYPE##_##IN_SIZE(self->in, &self->base,          \
+                                                                   input, BATCH);                  \
+        if (count == 0) { break; }                                                                 \
+        uint64_t start = hol_pipeline_now_ns();                                                    \
+        size_t produced = self->fn(self->ctx, input, count, output);                               \
+        if (produced > BATCH) { produced = BATCH; }                                                \
+        uint64_t stalled = pipeline_link_send_##OUT_TYPE##_##OUT_SIZE(self->out, &self->base,      \
+                                                                      output, produced);           \
+        HOL_PIPELINE_STAT_ADD(&self->base, busy_ns, hol_pipeline_now_ns() - start - stalled);      \
+        HOL_PIPELINE_STAT_ADD(&self->base, items_in, count);                                       \
+        HOL_PIPELINE_STAT_ADD(&self->base, items_out, produced);                                   \
+        HOL_PIPELINE_STAT_ADD(&self->base, batches, 1);                                            \
+    }                                                                                              \
+    pipeline_link_close_##OUT_TYPE##_##OUT_SIZE(self->out);                                        \
+    hol_pipeline_stage_end(&self->base);                                                           \
+    return NULL;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline bool NAME##_stage_add(hol_pipeline_t* pipeline, NAME##_stage_t* stage,               \
+    NAME##_stage_fn_t fn, void* ctx, pipeline_link_##IN_TYPE##_##IN_SIZE##_t* in,                  \
+    pipeline_link_##OUT_TYPE##_##OUT_SIZE##_t* out, int cpu)                                       \
+{                                                                                                  \
+    if (!hol_pipeline_add(pipeline, &stage->base, #NAME, NAME##_stage_main, cpu)) { return false; } \
+    stage->fn = fn;                                                                                \
+    stage->ctx = ctx;                                                                              \
+    stage->in = in;                                                                                \
+    stage->out = out;                                                                              \
+    stage->base.signals[0] = &in->signal;                                                          \
+    stage->base.signals[1] = &out->signal;                                                         \
+    return true;                                                                                   \
+}
+
+/**
+ * @brief Declare a sink stage: consumes IN_TYPE batches
+ * @param NAME     Stage name (prefix of the generated identifiers)
+ * @param IN_TYPE / IN_SIZE    Input link
+ * @param BATCH    Largest batch per call
+ *
+ * Stage function: void fn(void* ctx, const IN_TYPE* in, size_t count)
+ *
+ * Generates NAME_stage_t and
+ *   NAME_stage_add(pipeline, stage, fn, ctx, in_link, cpu)
+ */
+#define DECLARE_PIPELINE_SINK(NAME, IN_TYPE, IN_SIZE, BATCH)                                       \
+                                                                                                   \
+typedef void (*NAME##_stage_fn_t)(void* ctx, const IN_TYPE* in, size_t count);                     \
+                                                                                                   \
+typedef struct {                                                                                   \
+    hol_pipeline_stage_t base;                                                                     \
+    NAME##_stage_fn_t fn;                                                                          \
+    void* ctx;                                                                                     \
+    pipeline_link_##IN_TYPE##_##IN_SIZE##_t* in;                                                   \
+} NAME##_stage_t;                                                                                  \
+                                                                                                   \
+static void* NAME##_stage_main(void* arg)                                                          \
+{                                                                                                  \
+    NAME##_stage_t* self = (NAME##_stage_t*)arg;                                                   \
+    IN_TYPE input[BATCH];                                                                          \
+    hol_pipeline_stage_begin(&self->base);                                                         \
+    for (;;)                                                                                       \
+    {                                                                                              \
+        size_t count = pipeline_link_receive_##IN_TYPE##_##IN_SIZE(self->in, &self->base,          \
+                                                                   input, BATCH);                  \
+        if (count == 0) { break; }                                                                 \
+        uint64_t start = hol_pipeline_now_ns();                                                    \
+        self->fn(self->ctx, input, count);                                                         \
+        HOL_PIPELINE_STAT_ADD(&self->base, busy_ns, hol_pipeline_now_ns() - start);                \
+        HOL_PIPELINE_STAT_ADD(&self->base, items_in, count);                                       \
+        HOL_PIPELINE_STAT_ADD(&self->base, batches, 1);                                            \
+    }                                                                                              \
+    hol_pipeline_stage_end(&self->base);                                                           \
+    return NULL;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline bool NAME##_stage_add(hol_pipeline_t* pipeline, NAME##_stage_t* stage,               \
+    NAME##_stage_fn_t fn, void* ctx, pipeline_link_##IN_TYPE##_##IN_SIZE##_t* in, int cpu)         \
+{                                                                                                  \
+    if (!hol_pipeline_add(pipeline, &stage->base, #NAME, NAME##_stage_main, cpu)) { return false; } \
+    stage->fn = fn;                                                                                \
+    stage->ctx = ctx;                                                                              \
+    stage->in = in;                                                                                \
+    stage->base.signals[0] = &in->signal;                                                          \
+    return true;                                                                                   \
+}
+
+#endif /* HOL_PIPELINE_H */
@@ -19,6 +19,70 @@
 #include <stddef.h>
 #include <string.h>
 
+/* ==================== OPTIONAL STATISTICS ==================== */
+
+/**
+ * @brief Set to 1 to count pushes, pulls, drops and the high-water mark of every queue
+ * @note Adds sizeof(queue_stats_t) to each queue and one or two increments per operation.
+ *       Counters are plain (relaxed) increments made by the queue's own producer/consumer.
+ */
+#ifndef QUEUE_ENABLE_STATS
+#define QUEUE_ENABLE_STATS 0
+#endif
+
+/**
+ * @brief Per-queue counters (present in the queue only with QUEUE_ENABLE_STATS)
+ */
+typedef struct {
+    uint32_t pushes;        /* Items stored */
+    uint32_t pulls;         /* Items removed by pull / pull_multiple */
+    uint32_t drops;         /* push_no_overwrite rejected: queue full */
+    uint32_t overwrites;    /* push replaced the oldest item: queue full */
+    size_t   high_water;    /* Highest count seen */
+} queue_stats_t;
+
+#if QUEUE_ENABLE_STATS
+#define QUEUE_STATS_MEMBER                 queue_stats_t stats;
+#define QUEUE_STATS_ADD(self, field, n)    ((self)->stats.field += (uint32_t)(n))
+#define QUEUE_STATS_HIGH_WATER(self)                                                                       \
+    do { if((self)->count > (self)->stats.high_water) (self)->stats.high_water = (self)->count; } while(0)
+#define QUEUE_STATS_RESET(self)            memset(&(self)->stats, 0, sizeof((self)->stats))
+#define QUEUE_STATS_OF(self)               ((const queue_stats_t*)&(self)->stats)
+#else
+#define QUEUE_STATS_MEMBER
+#define QUEUE_STATS_ADD(self, field, n)    ((void)0)
+#define QUEUE_STATS_HIGH_WATER(self)       ((void)0)
+#define QUEUE_STATS_RESET(self)            ((void)0)
+#define QUEUE_STATS_OF(self)               ((const queue_stats_t*)NULL)
+#endif
+
+/* ==================== USDT TRACEPOINTS ==================== */
+
+/**
+ * @brief Set to 1 to compile static tracepoints for bpftrace / perf / SystemTap
+ * @note Needs <sys/sdt.h> (systemtap-sdt-dev / systemtap-sdt-devel). Each
+ *       probe is a single NOP until a tracer attaches; arguments are read
+ *       from registers only when it does.
+ *
+ * Probes (provider hol_queue), arguments: queue address, count after the
+ * operation, capacity:
+ *   push, pull, overwrite (push on a full queue), full (push_no_overwrite
+ *   rejected), empty (pull on an empty queue)
+ *
+ * bpftrace -e 'usdt:./app:hol_queue:full { @[arg0] = count(); }'
+ */
+#ifndef HOL_ENABLE_USDT
+#define HOL_ENABLE_USDT 0
+#endif
+
+#if HOL_ENABLE_USDT
+#include <sys/sdt.h>
+#define QUEUE_PROBE(name, self, SIZE)                                                                      \
+    DTRACE_PROBE3(hol_queue, name, (const void*)(self), (size_t)(self)->count, (size_t)(SIZE))
+#else
+#define QUEUE_PROBE(name, self, SIZE) ((void)0)
+#endif
+
 /**
  * @brief Queue status enumeration
  */
@@ -63,6 +127,7 @@ typedef struct {
     volatile size_t write_index;                                                                           \
     volatile size_t read_index;                                                                            \
     volatile size_t count;                                                                                 \
+    QUEUE_STATS_MEMBER                                                                                     \
 } queue_##TYPE##_##SIZE##_t;                                                                               \
                                                                                                            \
 static inline queue_##TYPE##_##SIZE##_status_e queue_initialize_##TYPE##_##SIZE(                           \
@@ -75,6 +140,7 @@ static inline queue_##TYPE##_##SIZE##_status_e queue_initialize_##TYPE##_##SIZE(
     self->write_index = 0;                                                                                 \
     self->read_index = 0;                                                                                  \
     self->count = 0;                                                                                       \
+    QUEUE_STATS_RESET(self);                                                                               \
                                                                                                            \
     return QUEUE_##TYPE##_##SIZE##_OK;                                                                     \
 }                                                                                                          \
@@ -121,6 +187,8 @@ static inline queue_##TYPE##_##SIZE##_status_e queue_push_##TYPE##_##SIZE(
     /* Handle full buffer (overwrite oldest data) */                                                       \
     if(self->count >= SIZE) {                                                                              \
         self->read_index = (self->read_index + 1) % SIZE;                                                  \
+        QUEUE_STATS_ADD(self, overwrites, 1);                                                              \
+        QUEUE_PROBE(overwrite, self, SIZE);                                                                \
     } else {                                                                                               \
         self->count++;                                                                                     \
     }                                                                                                      \
@@ -128,6 +196,9 @@ static inline queue_##TYPE##_##SIZE##_status_e queue_push_##TYPE##_##SIZE(
     /* Write data */                                                                                       \
     self->buffer[self->write_index] = data;                                                                \
     self->write_index = (self->write_index + 1) % SIZE;                                                    \
+    QUEUE_STATS_ADD(self, pushes, 1);                                                                      \
+    QUEUE_STATS_HIGH_WATER(self);                                                                          \
+    QUEUE_PROBE(push, self, SIZE);                                                                         \
                                                                                                            \
     return QUEUE_##TYPE##_##SIZE##_OK;                                                                     \
 }                                                                                                          \
@@ -140,12 +211,17 @@ static inline queue_##TYPE##_##SIZE##_status_e queue_push_no_overwrite_##TYPE##_
     }                                                                                                      \
                                                                                                            \
     if(self->count >= SIZE) {                                                                              \
+        QUEUE_STATS_ADD(self, drops, 1);                                                                   \
+        QUEUE_PROBE(full, self, SIZE);                                                                     \
         return QUEUE_##TYPE##_##SIZE##_ERROR_FULL;                                                         \
     }                                                                                                      \
                                                                                                            \
     self->buffer[self->write_index] = data;                                                                \
     self->write_index = (self->write_index + 1) % SIZE;                                                    \
     self->count++;                                                                                         \
+    QUEUE_STATS_ADD(self, pushes, 1);                                                                      \
+    QUEUE_STATS_HIGH_WATER(self);                                                                          \
+    QUEUE_PROBE(push, self, SIZE);                                                                         \
                                                                                                            \
     return QUEUE_##TYPE##_##SIZE##_OK;                                                                     \
 }                                                                                                          \
@@ -158,12 +234,15 @@ static inline queue_##TYPE##_##SIZE##_status_e queue_pull_##TYPE##_##SIZE(
     }                                                                                                      \
                                                                                                            \
     if(self->count == 0) {                                                                                 \
+        QUEUE_PROBE(empty, self, SIZE);                                                                    \
         return QUEUE_##TYPE##_##SIZE##_ERROR_EMPTY;                                                        \
     }                                                                                                      \
                                                                                                            \
     *data = self->buffer[self->read_index];                                                                \
     self->read_index = (self->read_index + 1) % SIZE;                                                      \
     self->count--;                                                                                         \
+    QUEUE_STATS_ADD(self, pulls, 1);                                                                       \
+    QUEUE_PROBE(pull, self, SIZE);                                                                         \
                                                                                                            \
     return QUEUE_##TYPE##_##SIZE##_OK;                                                                     \
 }                                                                                                          \
@@ -177,6 +256,7 @@ static inline queue_##TYPE##_##SIZE##_status_e queue_pull_multiple_##TYPE##_##SI
                                                                                                            \
     if(self->count == 0) {                                                                                 \
         if(read_count) *read_count = 0;                                                                    \
+        QUEUE_PROBE(empty, self, SIZE);                                                                    \
         return QUEUE_##TYPE##_##SIZE##_ERROR_EMPTY;                                                        \
     }                                                                                                      \
                                                                                                            \
@@ -189,6 +269,9 @@ static inline queue_##TYPE##_##SIZE##_status_e queue_pull_multiple_##TYPE##_##SI
         self->count--;                                                                                     \
     }                                                                                                      \
                                                                                                            \
+    QUEUE_STATS_ADD(self, pulls, actual_length);                                                           \
+    QUEUE_PROBE(pull, self, SIZE);                                                                         \
+                                                                                                           \
     if(read_count) {                                                                                       \
         *read_count = actual_length;                                                                       \
     }                                                                                                      \
@@ -222,6 +305,17 @@ static inline const TYPE* queue_peek_ptr_##TYPE##_##SIZE(
     return &self->buffer[self->read_index];                                                                \
 }                                                                                                          \
                                                                                                            \
+/* Counters of this queue, NULL unless QUEUE_ENABLE_STATS is set */                                        \
+static inline const queue_stats_t* queue_get_stats_##TYPE##_##SIZE(                                        \
+    const queue_##TYPE##_##SIZE##_t* self)                                                                 \
+{                                                                                                          \
+    if(!self) {                                                                                            \
+        return NULL;                                                                                       \
+    }                                                                                                      \
+                                                                                                           \
+    return QUEUE_STATS_OF(self);                                                                           \
+}                                                                                                          \
+                                                                                                           \
 static inline void queue_clear_##TYPE##_##SIZE(                                                            \
     queue_##TYPE##_##SIZE##_t* self)                                                                       \
 {                                                                                                          \
@@ -287,15 +381,390 @@ static inline int queue_pull_with_string_support_##STRING_SIZE##_##QUEUE_SIZE(
     return 0;                                                                                              \
 }
 
+/* ==================== LOCK-FREE SPSC QUEUE ==================== */
+
+/**
+ * @brief Cache line size used to keep the producer and consumer indices apart
+ */
+#ifndef QUEUE_CACHE_LINE
+#define QUEUE_CACHE_LINE 64
+#endif
+
+#ifndef QUEUE_CACHE_ALIGNED
+#if defined(__GNUC__) || defined(__clang__)
+#define QUEUE_CACHE_ALIGNED __attribute__((aligned(QUEUE_CACHE_LINE)))
+#else
+#define QUEUE_CACHE_ALIGNED
+#endif
+#endif
+
+/**
+ * @brief Index publication for the SPSC queue (acquire / release)
+ * @note Without GCC atomics these fall back to volatile accesses, which is only
+ *       safe between an ISR and the main loop of a single core. Override with
+ *       your toolchain's atomics (or add a __DMB() on multi-core MCUs).
+ */
+#ifndef QUEUE_LOAD_ACQUIRE
+#if defined(__GNUC__) || defined(__clang__)
+#define QUEUE_LOAD_ACQUIRE(ptr)         __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define QUEUE_STORE_RELEASE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#else
+#define QUEUE_LOAD_ACQUIRE(ptr)         (*(volatile size_t*)(ptr))
+#define QUEUE_STORE_RELEASE(ptr, value) (*(volatile size_t*)(ptr) = (value))
+#endif
+#endif
+
+/**
+ * @brief SPSC producer-side staging: publish head every N pushed elements
+ * @note 1 (default) publishes on every push. With N > 1 the producer stores
+ *       elements into their slots but moves the shared head only every N
+ *       elements, on spsc_queue_flush_TYPE_SIZE(), when the ring is full, or
+ *       from spsc_queue_flush_if_due_TYPE_SIZE(), so one cache-line transfer
+ *       covers N elements. Elements stay invisible to the consumer until
+ *       published: a producer that goes idle must flush.
+ */
+#ifndef QUEUE_SPSC_PUBLISH_BATCH
+#define QUEUE_SPSC_PUBLISH_BATCH 1
+#endif
+
+/**
+ * @brief Ticks (caller's clock) staged elements may wait in spsc_queue_flush_if_due_TYPE_SIZE()
+ */
+#ifndef QUEUE_SPSC_PUBLISH_DEADLINE
+#define QUEUE_SPSC_PUBLISH_DEADLINE 1
+#endif
+
+/**
+ * @brief Lock-free single-producer / single-consumer queue declaration macro
+ * @param TYPE Data type (u8, u32, custom struct, ...)
+ * @param SIZE Queue capacity (must be > 0; a power of two turns % into a mask)
+ *
+ * One thread (or ISR) pushes, one other thread pulls; no locks and no
+ * read-modify-write atomics. head and tail are free-running counters on
+ * separate cache lines. Each side keeps a private copy of the other side's
+ * index and re-reads the shared one only when its copy says full / empty,
+ * so the two cores exchange cache lines about once per SIZE items, not once
+ * per item. Full queues reject pushes: nothing is overwritten. With
+ * QUEUE_SPSC_PUBLISH_BATCH > 1 the producer also publishes head only every
+ * N elements (flush / flush_if_due publish the rest).
+ *
+ * Usage Example:
+ * DECLARE_SPSC_QUEUE(u32, 1024)
+ * static spsc_queue_u32_1024_t ring;
+ * spsc_queue_initialize_u32_1024(&ring);
+ * spsc_queue_push_u32_1024(&ring, 42);                       // Producer thread
+ * size_t n = spsc_queue_push_batch_u32_1024(&ring, arr, 16); // Producer: n <= 16 stored
+ * u32 item;
+ * if(spsc_queue_pull_u32_1024(&ring, &item)) { ... }         // Consumer thread
+ * n = spsc_queue_pull_batch_u32_1024(&ring, out, 64);        // Consumer: up to 64 items
+ * spsc_queue_flush_u32_1024(&ring);                          // Producer, before going idle
+ * spsc_queue_flush_if_due_u32_1024(&ring, now_ticks);        // Producer loop: bound staging delay
+ *
+ * @warning Exactly one producer and one consumer. For several producers
+ *          guard the producer side with a lock (or use one queue per producer).
+ */
+#define DECLARE_SPSC_QUEUE(TYPE, SIZE)                                                                     \
+                                                                                                           \
+                                                                                                           \
+typedef struct {                                                                                           \
+    volatile size_t head QUEUE_CACHE_ALIGNED;    /* Published write position (producer) */                 \
+    size_t staged_head;                          /* Next write; head <= staged_head (producer) */          \
+    size_t cached_tail;                          /* Producer's copy of tail */                             \
+    uint32_t staged_since;                       /* flush_if_due: first time staged items seen */          \
+    bool staged_timed;                                                                                     \
+    volatile size_t tail QUEUE_CACHE_ALIGNED;    /* Next read, free-running (consumer) */                  \
+    size_t cached_head;                          /* Consumer's copy of head */                             \
+    TYPE buffer[SIZE] QUEUE_CACHE_ALIGNED;                                                                 \
+} spsc_queue_##TYPE##_##SIZE##_t;                                                                          \
+                                                                                                           \
+static inline void spsc_queue_initialize_##TYPE##_##SIZE(                                                  \
+    spsc_queue_##TYPE##_##SIZE##_t* self)                                                                  \
+{                                                                                                          \
+    self->head = 0;                                                                                        \
+    self->staged_head = 0;                                                                                 \
+    self->cached_tail = 0;                                                                                 \
+    self->staged_since = 0;                                                                                \
+    self->staged_timed = false;                                                                            \
+    self->tail = 0;                                                                                        \
+    self->cached_head = 0;                                                                                 \
+}                                                                                                          \
+                                                                                                           \
+/* Producer side: make every staged element visible to the consumer */                                     \
+static inline void spsc_queue_flush_##TYPE##_##SIZE(                                                       \
+    spsc_queue_##TYPE##_##SIZE##_t* self)                                                                  \
+{                                                                                                          \
+    if(self->staged_head != self->head) {                                                                  \
+        QUEUE_STORE_RELEASE(&self->head, self->staged_head);                                               \
+    }                                                                                                      \
+    self->staged_timed = false;                                                                            \
+}                                                                                                          \
+                                                                                                           \
+/* Producer side: publish once QUEUE_SPSC_PUBLISH_BATCH elements are staged */                             \
+static inline void spsc_queue_publish_##TYPE##_##SIZE(                                                     \
+    spsc_queue_##TYPE##_##SIZE##_t* self)                                                                  \
+{                                                                                                          \
+    if(self->staged_head - self->head >= QUEUE_SPSC_PUBLISH_BATCH) {                                       \
+        spsc_queue_flush_##TYPE##_##SIZE(self);                                                            \
+    }                                                                                                      \
+}                                                                                                          \
+                                                                                                           \
+/* Producer side: flush if elements have been staged for QUEUE_SPSC_PUBLISH_DEADLINE ticks of now */       \
+static inline bool spsc_queue_flush_if_due_##TYPE##_##SIZE(                                                \
+    spsc_queue_##TYPE##_##SIZE##_t* self, uint32_t now)                                                    \
+{                                                                                                          \
+    if(self->staged_head == self->head) {                                                                  \
+        return false;                                                                                      \
+    }                                                                                                      \
+    if(!self->staged_timed) {                                                                              \
+        self->staged_timed = true;                                                                         \
+        self->staged_since = now;                                                                          \
+    }                                                                                                      \
+    if((uint32_t)(now - self->staged_since) < QUEUE_SPSC_PUBLISH_DEADLINE) {                               \
+        return false;                                                                                      \
+    }                                                                                                      \
+    spsc_queue_flush_##TYPE##_##SIZE(self);                                                                \
+    return true;                                                                                           \
+}                                                                                                          \
+                                                                                                           \
+/* Producer side: free slots, re-reading tail only when the cached copy is not enough */                   \
+static inline size_t spsc_queue_space_##TYPE##_##SIZE(                                                     \
+    spsc_queue_##TYPE##_##SIZE##_t* self, size_t wanted)                                                   \
+{                                                                                                          \
+    size_t space = SIZE - (self->staged_head - self->cached_tail);                                         \
+    if(space < wanted) {                                                                                   \
+        spsc_queue_flush_##TYPE##_##SIZE(self);  /* Full of staged items: let the consumer see them */     \
+        self->cached_tail = QUEUE_LOAD_ACQUIRE(&self->tail);                                               \
+        space = SIZE - (self->staged_head - self->cached_tail);                                            \
+    }                                                                                                      \
+    return space;                                                                                          \
+}                                                                                                          \
+                                                                                                           \
+/* Consumer side: items available, re-reading head only when the cached copy is not enough */              \
+static inline size_t spsc_queue_available_##TYPE##_##SIZE(                                                 \
+    spsc_queue_##TYPE##_##SIZE##_t* self, size_t wanted)                                                   \
+{                                                                                                          \
+    size_t available = self->cached_head - self->tail;                                                     \
+    if(available < wanted) {                                                                               \
+        self->cached_head = QUEUE_LOAD_ACQUIRE(&self->head);                                               \
+        available = self->cached_head - self->tail;                                                        \
+    }                                                                                                      \
+    return available;                                                                                      \
+}                                                                                                          \
+                                                                                                           \
+static inline bool spsc_queue_push_##TYPE##_##SIZE(                                                        \
+    spsc_queue_##TYPE##_##SIZE##_t* self, TYPE data)                                                       \
+{                                                                                                          \
+    if(spsc_queue_space_##TYPE##_##SIZE(self, 1) == 0) {                                                   \
+        return false;                                                                                      \
+    }                                                                                                      \
+                                                                                                           \
+    size_t head = self->staged_head;                                                                       \
+    self->buffer[head % SIZE] = data;                                                                      \
+    self->staged_head = head + 1;                                                                          \
+    spsc_queue_publish_##TYPE##_##SIZE(self);                                                              \
+    return true;                                                                                           \
+}                                                                                                          \
+                                                                                                           \
+/* Copy len items into the ring starting at position index (wraps once at most) */                         \
+static inline void spsc_queue_copy_in_##TYPE##_##SIZE(                                                     \
+    spsc_queue_##TYPE##_##SIZE##_t* self, size_t index, const TYPE* data, size_t len)                      \
+{                                                                                                          \
+    size_t start = index % SIZE;                                                                           \
+    size_t first = (len < SIZE - start) ? len : SIZE - start;                                              \
+    memcpy(&self->buffer[start], data, first * sizeof(TYPE));                                              \
+    memcpy(&self->buffer[0], data + first, (len - first) * sizeof(TYPE));                                  \
+}                                                                                                          \
+                                                                                                           \
+static inline size_t spsc_queue_push_batch_##TYPE##_##SIZE(                                                \
+    spsc_queue_##TYPE##_##SIZE##_t* self, const TYPE* data, size_t len)                                    \
+{                                                                                                          \
+    size_t space = spsc_queue_space_##TYPE##_##SIZE(self, len);                                            \
+    if(len > space) {                                                                                      \
+        len = space;                                                                                       \
+    }                                                                                                      \
+    if(len == 0) {                                                                                         \
+        return 0;                                                                                          \
+    }                                                                                                      \
+                                                                                                           \
+    size_t head = self->staged_head;                                                                       \
+    spsc_queue_copy_in_##TYPE##_##SIZE(self, head, data, len);                                             \
+    self->staged_head = head + len;                                                                        \
+    spsc_queue_publish_##TYPE##_##SIZE(self);                                                              \
+    return len;                                                                                            \
+}                                                                                                          \
+                                                                                                           \
+static inline bool spsc_queue_pull_##TYPE##_##SIZE(                                                        \
+    spsc_queue_##TYPE##_##SIZE##_t* self, TYPE* data)                                                      \
+{                                                                                                          \
+    if(spsc_queue_available_##TYPE##_##SIZE(self, 1) == 0) {                                               \
+        return false;                                                                                      \
+    }                                                                                                      \
+                                                                                                           \
+    size_t tail = self->tail;                                                                              \
+    *data = self->buffer[tail % SIZE];                                                                     \
+    QUEUE_STORE_RELEASE(&self->tail, tail + 1);                                                            \
+    return true;                                                                                           \
+}                                                                                                          \
+                                                                                                           \
+static inline size_t spsc_queue_pull_batch_##TYPE##_##SIZE(                                                \
+    spsc_queue_##TYPE##_##SIZE##_t* self, TYPE* data, size_t max_len)                                      \
+{                                                                                                          \
+    size_t len = spsc_queue_available_##TYPE##_##SIZE(self, max_len);                                      \
+    if(len > max_len) {                                                                                    \
+        len = max_len;                                                                                     \
+    }                                                                                                      \
+    if(len == 0) {                                                                                         \
+        return 0;                                                                                          \
+    }                                                                                                      \
+                                                                                                           \
+    size_t tail = self->tail;                                                                              \
+    size_t start = tail % SIZE;                                                                            \
+    size_t first = (len < SIZE - start) ? len : SIZE - start;                                              \
+    memcpy(data, &self->buffer[start], first * sizeof(TYPE));                                              \
+    memcpy(data + first, &self->buffer[0], (len - first) * sizeof(TYPE));                                  \
+    QUEUE_STORE_RELEASE(&self->tail, tail + len);                                                          \
+    return len;                                                                                            \
+}                                                                                                          \
+                                                                                                           \
+/* Approximate from any thread; exact from the producer or consumer when the other side is idle */         \
+static inline size_t spsc_queue_count_##TYPE##_##SIZE(                                                     \
+    const spsc_queue_##TYPE##_##SIZE##_t* self)                                                            \
+{                                                                                                          \
+    return QUEUE_LOAD_ACQUIRE(&self->head) - QUEUE_LOAD_ACQUIRE(&self->tail);                              \
+}                                                                                                          \
+                                                                                                           \
+static inline bool spsc_queue_is_empty_##TYPE##_##SIZE(                                                    \
+    const spsc_queue_##TYPE##_##SIZE##_t* self)                                                            \
+{                                                                                                          \
+    return spsc_queue_count_##TYPE##_##SIZE(self) == 0;                                                    \
+}
+
+/* ==================== LOCK-FREE MPSC QUEUE ==================== */
+
+/**
+ * @brief Bounded multi-producer / single-consumer queue declaration macro
+ * @param TYPE Data type (u8, u32, custom struct, ...)
+ * @param SIZE Queue capacity (must be > 0; a power of two turns % into a mask)
+ *
+ * Any number of threads push, one thread pulls. Producers claim a slot with
+ * one compare-and-swap on tail; each slot carries a sequence number that
+ * tells the consumer when the data is complete and tells producers when the
+ * slot is free again, so producers never wait for each other's copy and the
+ * consumer needs no atomic read-modify-write. Full queues reject pushes.
+ *
+ * Usage Example:
+ * DECLARE_MPSC_QUEUE(u32, 64)
+ * static mpsc_queue_u32_64_t mailbox;
+ * mpsc_queue_initialize_u32_64(&mailbox);
+ * if(!mpsc_queue_push_u32_64(&mailbox, 42)) { ... }          // Any thread
+ * u32 item;
+ * while(mpsc_queue_pull_u32_64(&mailbox, &item)) { ... }     // Consumer thread only
+ *
+ * @note Needs GCC / Clang __atomic builtins (compare-and-swap).
+ */
+#define DECLARE_MPSC_QUEUE(TYPE, SIZE)                                                                     \
+                                                                                                           \
+typedef struct {                                                                                           \
+    volatile size_t sequence;                    /* == position: free; == position + 1: filled */          \
+    TYPE data;                                                                                             \
+} mpsc_queue_##TYPE##_##SIZE##_slot_t;                                                                     \
+                                                                                                           \
+typedef struct {                                                                                           \
+    volatile size_t tail QUEUE_CACHE_ALIGNED;    /* Next position to claim (producers) */                  \
+    volatile size_t head QUEUE_CACHE_ALIGNED;    /* Next position to read (consumer) */                    \
+    mpsc_queue_##TYPE##_##SIZE##_slot_t slots[SIZE];                                                       \
+} mpsc_queue_##TYPE##_##SIZE##_t;                                                                          \
+                                                                                                           \
+static inline void mpsc_queue_initialize_##TYPE##_##SIZE(                                                  \
+    mpsc_queue_##TYPE##_##SIZE##_t* self)                                                                  \
+{                                                                                                          \
+    for(size_t i = 0; i < SIZE; i++) {                                                                     \
+        self->slots[i].sequence = i;                                                                       \
+    }                                                                                                      \
+    self->tail = 0;                                                                                        \
+    self->head = 0;                                                                                        \
+}                                                                                                          \
+                                                                                                           \
+static inline bool mpsc_queue_push_##TYPE##_##SIZE(                                                        \
+    mpsc_queue_##TYPE##_##SIZE##_t* self, TYPE data)                                                       \
+{                                                                                                          \
+    size_t position = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);                                      \
+    mpsc_queue_##TYPE##_##SIZE##_slot_t* slot;                                                             \
+    for(;;) {                                                                                              \
+        slot = &self->slots[position % SIZE];                                                              \
+        size_t sequence = QUEUE_LOAD_ACQUIRE(&slot->sequence);                                             \
+        ptrdiff_t lag = (ptrdiff_t)(sequence - position);                                                  \
+        if(lag == 0) {                                                                                     \
+            if(__atomic_compare_exchange_n(&self->tail, &position, position + 1, true,                     \
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {                          \
+                break;                                                                                     \
+            }                                                                                              \
+        } else if(lag < 0) {                                                                               \
+            return false;                        /* Slot still holds the item from one lap ago */          \
+        } else {                                                                                           \
+            position = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);                                     \
+        }                                                                                                  \
+    }                                                                                                      \
+                                                                                                           \
+    slot->data = data;                                                                                     \
+    QUEUE_STORE_RELEASE(&slot->sequence, position + 1);                                                    \
+    return true;                                                                                           \
+}                                                                                                          \
+                                                                                                           \
+static inline bool mpsc_queue_pull_##TYPE##_##SIZE(                                                        \
+    mpsc_queue_##TYPE##_##SIZE##_t* self, TYPE* data)                                                      \
+{                                                                                                          \
+    size_t head = self->head;                                                                              \
+    mpsc_queue_##TYPE##_##SIZE##_slot_t* slot = &self->slots[head % SIZE];                                 \
+    if(QUEUE_LOAD_ACQUIRE(&slot->sequence) != head + 1) {                                                  \
+        return false;                            /* Empty, or the producer is still copying */             \
+    }                                                                                                      \
+                                                                                                           \
+    *data = slot->data;                                                                                    \
+    QUEUE_STORE_RELEASE(&slot->sequence, head + SIZE);                                                     \
+    QUEUE_STORE_RELEASE(&self->head, head + 1);                                                            \
+    return true;                                                                                           \
+}                                                                                                          \
+                                                                                                           \
+static inline size_t mpsc_queue_pull_batch_##TYPE##_##SIZE(                                                \
+    mpsc_queue_##TYPE##_##SIZE##_t* self, TYPE* data, size_t max_len)                                      \
+{                                                                                                          \
+    size_t len = 0;                                                                                        \
+    while(len < max_len && mpsc_queue_pull_##TYPE##_##SIZE(self, &data[len])) {                            \
+        len++;                                                                                             \
+    }                                                                                                      \
+    return len;                                                                                            \
+}                                                                                                          \
+                                                                                                           \
+/* Approximate from any thread (claimed slots may still be in the middle of a copy) */                     \
+static inline size_t mpsc_queue_count_##TYPE##_##SIZE(                                                     \
+    const mpsc_queue_##TYPE##_##SIZE##_t* self)                                                            \
+{                                                                                                          \
+    size_t head = QUEUE_LOAD_ACQUIRE(&self->head);                                                         \
+    size_t tail = QUEUE_LOAD_ACQUIRE(&self->tail);                                                         \
+    return (tail > head) ? tail - head : 0;                                                                \
+}                                                                                                          \
+                                                                                                           \
+/* Consumer side (or a thread that just handed the consumer role over): true if the next pull would fail */\
+static inline bool mpsc_queue_is_empty_##TYPE##_##SIZE(                                                    \
+    const mpsc_queue_##TYPE##_##SIZE##_t* self)                                                            \
+{                                                                                                          \
+    size_t head = QUEUE_LOAD_ACQUIRE(&self->head);                                                         \
+    return QUEUE_LOAD_ACQUIRE(&self->slots[head % SIZE].sequence) != head + 1;                             \
+}
+
 /* ==================== HELPER MACROS ==================== */
 
 /**
- * @brief Calculate memory usage of a queue
+ * @brief Calculate memory usage of a queue (RAM of one instance, padding included)
  *
  * Usage:
  * size_t size_bytes = QUEUE_MEMORY_BYTES(u16, 64);
+ *
+ * @note Needs DECLARE_QUEUE(TYPE, SIZE). Code size per instantiation:
+ *       Tools/hol_footprint.sh
  */
-#define QUEUE_MEMORY_BYTES(TYPE, SIZE) (sizeof(TYPE) * (SIZE) + sizeof(size_t) * 3)
+#define QUEUE_MEMORY_BYTES(TYPE, SIZE) sizeof(queue_##TYPE##_##SIZE##_t)
 
 /**
  * @brief Declare and initialize a queue in one line
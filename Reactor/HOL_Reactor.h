@@ -0,0 +1,552 @@
+/**
+ * @file HOL_Reactor.h
+ * @brief Single-threaded epoll reactor: library queues, descriptors and timers in one loop (Linux)
+ *
+ * @section Features
+ * - One epoll set serves sockets, pipes, timerfds ... and library queues
+ * - Queue sources: a DECLARE_MPSC_QUEUE ring plus an eventfd; any thread
+ *   pushes, and only the push that finds the queue idle pays the write()
+ * - Batched dispatch: queue handlers receive up to HOL_REACTOR_BATCH items
+ *   per call; a source with work left after HOL_REACTOR_BUDGET items is
+ *   dispatched again on the next iteration without waiting (fairness)
+ * - Timers: an embedded HOL_TimerWheel (1 tick = 1 ms) bounds the epoll
+ *   timeout, so nothing sleeps past a timer and nothing polls
+ * - Loop-iteration latency: count, mean, max and a log2 histogram of the
+ *   time from wake-up to the end of dispatch (p50 / p99 in the report)
+ * - Zero dynamic memory: reactor and sources are caller-owned objects
+ *
+ * @section Usage_Example
+ * @code
+ * #include "HOL_Reactor.h"
+ *
+ * typedef struct { uint32_t id; uint8_t op; } job_t;
+ * DECLARE_MPSC_QUEUE(job_t, 256)
+ * DECLARE_REACTOR_QUEUE(jobs, job_t, 256)
+ *
+ * static hol_reactor_t reactor;
+ * static jobs_reactor_queue_t jobs;
+ * static hol_reactor_source_t sock_src;
+ * static hol_timer_t flush_timer;
+ *
+ * static void on_jobs(hol_reactor_t* r, job_t* items, size_t count, void* ctx) { ... }
+ * static bool on_sock(hol_reactor_t* r, hol_reactor_source_t* src, uint32_t events) {
+ *     ... read up to N messages from src->fd ...
+ *     return more_to_read;                     // true: dispatch again next iteration
+ * }
+ * static void on_flush(hol_timer_t* t, void* ctx) { APP_log_flush(0); }
+ *
+ * hol_reactor_init(&reactor);
+ * jobs_reactor_queue_init(&jobs, &reactor, on_jobs, NULL);
+ * hol_reactor_add(&reactor, &sock_src, sock_fd, EPOLLIN, on_sock, NULL);
+ * hol_timer_init(&flush_timer, on_flush, NULL);
+ * hol_reactor_timer_start(&reactor, &flush_timer, 100, 100);
+ *
+ * jobs_reactor_queue_push(&jobs, &job);        // Any thread
+ * hol_reactor_run(&reactor);                   // Until hol_reactor_stop()
+ * hol_reactor_report(&reactor, stdout);
+ * @endcode
+ *
+ * @warning Everything except hol_reactor_stop(), hol_reactor_wake() and the
+ *          queue push runs on the reactor thread: handlers must not block.
+ */
+
+#ifndef HOL_REACTOR_H
+#define HOL_REACTOR_H
+
+#if !defined(__linux__)
+#error "HOL_Reactor.h needs Linux (epoll, eventfd)"
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "../Queue/HOL_Queue.h"
+#include "../TimerWheel/HOL_TimerWheel.h"
+
+/* ==================== CONFIGURATION ==================== */
+
+/**
+ * @brief Queue items handed to one handler call
+ */
+#ifndef HOL_REACTOR_BATCH
+#define HOL_REACTOR_BATCH 32
+#endif
+
+/**
+ * @brief Queue items per source per loop iteration before other sources get their turn
+ */
+#ifndef HOL_REACTOR_BUDGET
+#define HOL_REACTOR_BUDGET 256
+#endif
+
+/**
+ * @brief epoll events fetched per iteration
+ */
+#ifndef HOL_REACTOR_MAX_EVENTS
+#define HOL_REACTOR_MAX_EVENTS 64
+#endif
+
+/* Latency histogram: bucket b counts iterations of [2^(b-1), 2^b) ns */
+#define HOL_REACTOR_HIST_BUCKETS 32
+
+/* ==================== TYPES ==================== */
+
+typedef struct hol_reactor hol_reactor_t;
+typedef struct hol_reactor_source hol_reactor_source_t;
+
+/**
+ * @brief Source handler
+ * @param events epoll events (EPOLLIN, EPOLLOUT, EPOLLHUP ...); 0 when the
+ *               source is dispatched again because it reported leftover work
+ * @return true if work is left: dispatched again next iteration without waiting
+ */
+typedef bool (*hol_reactor_fn_t)(hol_reactor_t* reactor, hol_reactor_source_t* source,
+                                 uint32_t events);
+
+struct hol_reactor_source {
+    int                   fd;
+    uint32_t              events;              /* Registered epoll interest */
+    hol_reactor_fn_t      fn;
+    void*                 ctx;
+    hol_reactor_t*        reactor;             /* NULL when not registered */
+    hol_reactor_source_t* next_ready;
+    bool                  ready;               /* In the leftover-work list */
+    uint64_t              dispatches;
+};
+
+typedef struct {
+    uint64_t iterations;
+    uint64_t dispatches;
+    uint64_t timers_fired;
+    uint64_t busy_ns;                          /* Sum of wake-to-dispatched times */
+    uint64_t max_busy_ns;
+    uint64_t hist[HOL_REACTOR_HIST_BUCKETS];
+} hol_reactor_stats_t;
+
+struct hol_reactor {
+    int                   epoll_fd;
+    int                   stop;
+    hol_reactor_source_t  wake;                /* eventfd for stop / wake from other threads */
+    hol_timer_wheel_t     timers;              /* 1 tick = 1 ms */
+    uint64_t              origin_ns;
+    hol_reactor_source_t* ready;               /* Sources with leftover work */
+    hol_reactor_source_t* draining;            /* Rest of the list being dispatched */
+    struct epoll_event    events[HOL_REACTOR_MAX_EVENTS];
+    int                   event_index;
+    int                   event_count;
+    hol_reactor_stats_t   stats;
+};
+
+/* ==================== INTERNALS ==================== */
+
+static inline uint64_t hol_reactor_clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t hol_reactor_now_ms(const hol_reactor_t* reactor)
+{
+    return (uint32_t)((hol_reactor_clock_ns() - reactor->origin_ns) / 1000000ull);
+}
+
+static inline void hol_reactor_eventfd_clear(int fd)
+{
+    uint64_t value;
+    ssize_t rc = read(fd, &value, sizeof(value));
+    (void)rc;                                  /* EAGAIN: already clear */
+}
+
+static inline void hol_reactor_eventfd_signal(int fd)
+{
+    uint64_t one = 1;
+    ssize_t rc = write(fd, &one, sizeof(one));
+    (void)rc;                                  /* EAGAIN only at 2^64 - 1 pending */
+}
+
+static bool hol_reactor_on_wake(hol_reactor_t* reactor, hol_reactor_source_t* source,
+                                uint32_t events)
+{
+    (void)reactor;
+    (void)events;
+    hol_reactor_eventfd_clear(source->fd);
+    return false;
+}
+
+static inline void hol_reactor_unlink_ready(hol_reactor_source_t** list,
+                                            hol_reactor_source_t* source)
+{
+    for (hol_reactor_source_t** link = list; *link; link = &(*link)->next_ready)
+    {
+        if (*link == source)
+        {
+            *link = source->next_ready;
+            return;
+        }
+    }
+}
+
+static inline void hol_reactor_dispatch(hol_reactor_t* reactor, hol_reactor_source_t* source,
+                                        uint32_t events)
+{
+    bool more = source->fn(reactor, source, events);
+    source->dispatches++;
+    reactor->stats.dispatches++;
+    if (source->reactor != reactor) { return; }   /* Removed by its handler */
+    if (more && !source->ready)
+    {
+        source->ready = true;
+        source->next_ready = reactor->ready;
+        reactor->ready = source;
+    }
+    else if (!more && source->ready)          /* Caught up since it asked to be called again */
+    {
+        hol_reactor_unlink_ready(&reactor->ready, source);
+        source->ready = false;
+        source->next_ready = NULL;
+    }
+}
+
+static inline void hol_reactor_record(hol_reactor_t* reactor, uint64_t busy_ns)
+{
+    hol_reactor_stats_t* stats = &reactor->stats;
+    unsigned bucket = 0;
+    while (bucket + 1 < HOL_REACTOR_HIST_BUCKETS && (busy_ns >> bucket) != 0) { bucket++; }
+    stats->hist[bucket]++;
+    stats->iterations++;
+    stats->busy_ns += busy_ns;
+    if (busy_ns > stats->max_busy_ns) { stats->max_busy_ns = busy_ns; }
+}
+
+/* ==================== SOURCES ==================== */
+
+/**
+ * @brief Watch a file descriptor (set O_NONBLOCK: handlers may be called with nothing to read)
+ * @param events EPOLLIN, EPOLLOUT, EPOLLET ... (level triggered unless EPOLLET)
+ * @return 0 or the epoll_ctl() errno
+ */
+static inline int hol_reactor_add(hol_reactor_t* reactor, hol_reactor_source_t* source, int fd,
+                                  uint32_t events, hol_reactor_fn_t fn, void* ctx)
+{
+    memset(source, 0, sizeof(*source));
+    source->fd = fd;
+    source->events = events;
+    source->fn = fn;
+    source->ctx = ctx;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = source;
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) { return errno; }
+    source->reactor = reactor;
+    return 0;
+}
+
+/**
+ * @brief Change the epoll interest of a registered source
+ */
+static inline int hol_reactor_modify(hol_reactor_t* reactor, hol_reactor_source_t* source,
+                                     uint32_t events)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = source;
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_MOD, source->fd, &ev) != 0) { return errno; }
+    source->events = events;
+    return 0;
+}
+
+/**
+ * @brief Stop watching a source (safe from any handler, including its own)
+ * @note Does not close the descriptor.
+ */
+static inline void hol_reactor_remove(hol_reactor_t* reactor, hol_reactor_source_t* source)
+{
+    if (source->reactor != reactor) { return; }
+    (void)epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+    if (source->ready)
+    {
+        hol_reactor_unlink_ready(&reactor->ready, source);
+        source->ready = false;
+    }
+    hol_reactor_unlink_ready(&reactor->draining, source);
+    for (int i = reactor->event_index + 1; i < reactor->event_count; i++)
+    {
+        if (reactor->events[i].data.ptr == source) { reactor->events[i].data.ptr = NULL; }
+    }
+    source->next_ready = NULL;
+    source->reactor = NULL;
+}
+
+/* ==================== REACTOR ==================== */
+
+/**
+ * @brief Create the epoll set and the wake eventfd
+ * @return 0 or errno
+ */
+static inline int hol_reactor_init(hol_reactor_t* reactor)
+{
+    memset(reactor, 0, sizeof(*reactor));
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor->epoll_fd < 0) { return errno; }
+    int wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0)
+    {
+        int err = errno;
+        close(reactor->epoll_fd);
+        return err;
+    }
+    int err = hol_reactor_add(reactor, &reactor->wake, wake_fd, EPOLLIN, hol_reactor_on_wake, NULL);
+    if (err != 0)
+    {
+        close(wake_fd);
+        close(reactor->epoll_fd);
+        return err;
+    }
+    reactor->origin_ns = hol_reactor_clock_ns();
+    hol_timer_wheel_init(&reactor->timers, 0);
+    return 0;
+}
+
+/**
+ * @brief Close the epoll set and the wake eventfd (sources' own descriptors stay open)
+ */
+static inline void hol_reactor_close(hol_reactor_t* reactor)
+{
+    close(reactor->wake.fd);
+    close(reactor->epoll_fd);
+    reactor->epoll_fd = -1;
+}
+
+/**
+ * @brief Start (or restart) a timer on the reactor clock, in milliseconds
+ */
+static inline void hol_reactor_timer_start(hol_reactor_t* reactor, hol_timer_t* timer,
+                                           uint32_t delay_ms, uint32_t period_ms)
+{
+    uint32_t lag = hol_reactor_now_ms(reactor) - reactor->timers.now;   /* Since the last advance */
+    hol_timer_start(&reactor->timers, timer, delay_ms + lag, period_ms);
+}
+
+static inline bool hol_reactor_timer_cancel(hol_reactor_t* reactor, hol_timer_t* timer)
+{
+    return hol_timer_cancel(&reactor->timers, timer);
+}
+
+/**
+ * @brief Interrupt epoll_wait() (any thread)
+ */
+static inline void hol_reactor_wake(hol_reactor_t* reactor)
+{
+    hol_reactor_eventfd_signal(reactor->wake.fd);
+}
+
+/**
+ * @brief Make hol_reactor_run() return after the current iteration (any thread)
+ */
+static inline void hol_reactor_stop(hol_reactor_t* reactor)
+{
+    __atomic_store_n(&reactor->stop, 1, __ATOMIC_RELEASE);
+    hol_reactor_wake(reactor);
+}
+
+/**
+ * @brief One loop iteration: wait, dispatch ready sources, fire due timers
+ * @param timeout_ms Longest wait (-1 = until an event or the next timer)
+ * @return Events received, or -errno
+ */
+static inline int hol_reactor_run_once(hol_reactor_t* reactor, int timeout_ms)
+{
+    int wait_ms = timeout_ms;
+    if (reactor->ready)
+    {
+        wait_ms = 0;                           /* Leftover work: poll only */
+    }
+    else
+    {
+        uint32_t until = hol_timer_wheel_ticks_until_next(&reactor->timers);
+        if (until != HOL_TIMER_NEVER)
+        {
+            int32_t left = (int32_t)(reactor->timers.now + until - hol_reactor_now_ms(reactor));
+            if (left < 0) { left = 0; }
+            if (wait_ms < 0 || left < wait_ms) { wait_ms = (int)left; }
+        }
+    }
+
+    int count = epoll_wait(reactor->epoll_fd, reactor->events, HOL_REACTOR_MAX_EVENTS, wait_ms);
+    if (count < 0)
+    {
+        if (errno != EINTR) { return -errno; }
+        count = 0;
+    }
+    uint64_t start = hol_reactor_clock_ns();
+
+    reactor->draining = reactor->ready;
+    reactor->ready = NULL;
+    hol_reactor_source_t* source;
+    while ((source = reactor->draining) != NULL)
+    {
+        reactor->draining = source->next_ready;
+        source->next_ready = NULL;
+        source->ready = false;
+        hol_reactor_dispatch(reactor, source, 0);
+    }
+
+    reactor->event_count = count;
+    for (reactor->event_index = 0; reactor->event_index < count; reactor->event_index++)
+    {
+        struct epoll_event* ev = &reactor->events[reactor->event_index];
+        source = (hol_reactor_source_t*)ev->data.ptr;   /* NULL: removed by an earlier handler */
+        if (source) { hol_reactor_dispatch(reactor, source, ev->events); }
+    }
+    reactor->event_count = 0;
+
+    uint32_t now_ms = hol_reactor_now_ms(reactor);
+    reactor->stats.timers_fired += hol_timer_wheel_advance(&reactor->timers, now_ms);
+    hol_reactor_record(reactor, hol_reactor_clock_ns() - start);
+    return count;
+}
+
+/**
+ * @brief Run iterations until hol_reactor_stop()
+ * @return 0, or -errno from epoll_wait()
+ */
+static inline int hol_reactor_run(hol_reactor_t* reactor)
+{
+    while (!__atomic_load_n(&reactor->stop, __ATOMIC_ACQUIRE))
+    {
+        int rc = hol_reactor_run_once(reactor, -1);
+        if (rc < 0) { return rc; }
+    }
+    reactor->stop = 0;
+    return 0;
+}
+
+/* Upper bound (ns) of the histogram bucket holding the given percentile */
+static inline uint64_t hol_reactor_percentile_ns(const hol_reactor_stats_t* stats, double pct)
+{
+    uint64_t target = (uint64_t)((double)stats->iterations * pct / 100.0);
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < HOL_REACTOR_HIST_BUCKETS; b++)
+    {
+        seen += stats->hist[b];
+        if (seen > target) { return (uint64_t)1 << b; }
+    }
+    return stats->max_busy_ns;
+}
+
+/**
+ * @brief Iterations, dispatches, timers and loop-iteration latency (reactor thread or after run)
+ */
+static inline void hol_reactor_report(const hol_reactor_t* reactor, FILE* out)
+{
+    const hol_reactor_stats_t* stats = &reactor->stats;
+    fprintf(out, "iterations %llu  dispatches %llu  timers %llu\n",
+            (unsigned long long)stats->iterations, (unsigned long long)stats->dispatches,
+            (unsigned long long)stats->timers_fired);
+    if (stats->iterations == 0) { return; }
+    fprintf(out, "iteration latency (wake to dispatched): mean %.0f ns  p50 < %llu ns"
+            "  p99 < %llu ns  max %llu ns\n",
+            (double)stats->busy_ns / (double)stats->iterations,
+            (unsigned long long)hol_reactor_percentile_ns(stats, 50.0),
+            (unsigned long long)hol_reactor_percentile_ns(stats, 99.0),
+            (unsigned long long)stats->max_busy_ns);
+}
+
+/* ==================== QUEUE SOURCES ==================== */
+
+/**
+ * @brief Declare a queue event source
+ * @param NAME Source type name (prefix of the generated identifiers)
+ * @param TYPE Item type
+ * @param SIZE Queue capacity; needs DECLARE_MPSC_QUEUE(TYPE, SIZE) first
+ *
+ * Handler: void fn(hol_reactor_t* reactor, TYPE* items, size_t count, void* ctx)
+ *
+ * Generates NAME_reactor_queue_t (source, queue, handler, ctx) and
+ *   NAME_reactor_queue_init(rq, reactor, handler, ctx)   0 or errno
+ *   NAME_reactor_queue_push(rq, &item)                   any thread; false if full
+ *   NAME_reactor_queue_close(rq)                         unregister, close the eventfd
+ *
+ * The eventfd is written only by the push that finds the source idle
+ * (notified == 0); the reactor clears the flag before draining, so a push
+ * that races with the drain signals again instead of being missed.
+ */
+#define DECLARE_REACTOR_QUEUE(NAME, TYPE, SIZE)                                                    \
+                                                                                                   \
+typedef void (*NAME##_reactor_queue_fn_t)(hol_reactor_t* reactor, TYPE* items, size_t count,       \
+                                          void* ctx);                                              \
+                                                                                                   \
+typedef struct {                                                                                   \
+    hol_reactor_source_t source;                                                                   \
+    mpsc_queue_##TYPE##_##SIZE##_t queue;                                                          \
+    NAME##_reactor_queue_fn_t handler;                                                             \
+    void* ctx;                                                                                     \
+    int notified;                              /* eventfd written since the last drain */          \
+} NAME##_reactor_queue_t;                                                                          \
+                                                                                                   \
+static bool NAME##_reactor_queue_dispatch(hol_reactor_t* reactor, hol_reactor_source_t* source,    \
+                                          uint32_t events)                                         \
+{                                                                                                  \
+    NAME##_reactor_queue_t* rq = (NAME##_reactor_queue_t*)source->ctx;                             \
+    if (events & EPOLLIN) { hol_reactor_eventfd_clear(source->fd); }                               \
+    __atomic_store_n(&rq->notified, 0, __ATOMIC_RELAXED);                                          \
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);   /* Flag store before the queue loads */             \
+                                                                                                   \
+    TYPE batch[HOL_REACTOR_BATCH];                                                                 \
+    size_t handled = 0;                                                                            \
+    while (handled < HOL_REACTOR_BUDGET)                                                           \
+    {                                                                                              \
+        size_t count = mpsc_queue_pull_batch_##TYPE##_##SIZE(&rq->queue, batch, HOL_REACTOR_BATCH); \
+        if (count == 0) { return false; }                                                          \
+        rq->handler(reactor, batch, count, rq->ctx);                                               \
+        handled += count;                                                                          \
+    }                                                                                              \
+    return !mpsc_queue_is_empty_##TYPE##_##SIZE(&rq->queue);                                       \
+}                                                                                                  \
+                                                                                                   \
+static inline int NAME##_reactor_queue_init(NAME##_reactor_queue_t* rq, hol_reactor_t* reactor,    \
+                                            NAME##_reactor_queue_fn_t handler, void* ctx)          \
+{                                                                                                  \
+    mpsc_queue_initialize_##TYPE##_##SIZE(&rq->queue);                                             \
+    rq->handler = handler;                                                                         \
+    rq->ctx = ctx;                                                                                 \
+    rq->notified = 0;                                                                              \
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);                                               \
+    if (fd < 0) { return errno; }                                                                  \
+    int err = hol_reactor_add(reactor, &rq->source, fd, EPOLLIN,                                   \
+                              NAME##_reactor_queue_dispatch, rq);                                  \
+    if (err != 0) { close(fd); }                                                                   \
+    return err;                                                                                    \
+}                                                                                                  \
+                                                                                                   \
+static inline bool NAME##_reactor_queue_push(NAME##_reactor_queue_t* rq, const TYPE* item)         \
+{                                                                                                  \
+    if (!mpsc_queue_push_##TYPE##_##SIZE(&rq->queue, *item)) { return false; }                     \
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);   /* Queue store before the flag load */              \
+    if (__atomic_load_n(&rq->notified, __ATOMIC_RELAXED) == 0 &&                                   \
+        __atomic_exchange_n(&rq->notified, 1, __ATOMIC_ACQ_REL) == 0)                              \
+    {                                                                                              \
+        hol_reactor_eventfd_signal(rq->source.fd);                                                 \
+    }                                                                                              \
+    return true;                                                                                   \
+}                                                                                                  \
+                                                                                                   \
+static inline void NAME##_reactor_queue_close(NAME##_reactor_queue_t* rq)                          \
+{                                                                                                  \
+    if (rq->source.reactor) { hol_reactor_remove(rq->source.reactor, &rq->source); }               \
+    close(rq->source.fd);                                                                          \
+}
+
+#endif /* HOL_REACTOR_H */
@@ -0,0 +1,448 @@
+/**
+ * @file HOL_TimerWheel.h
+ * @brief Hierarchical timing wheel with static storage for flushes, retries and timeouts
+ *
+ * @section Features
+ * - O(1) start, restart and cancel: timers are intrusive list nodes owned by the caller
+ * - HOL_TIMER_WHEEL_LEVELS levels of 64 slots; level n covers 64^(n+1) ticks, so
+ *   4 levels span 16.7 M ticks (4.6 hours at 1 ms) and timers cascade down
+ *   one level at a time as they approach
+ * - Batched expiry: one hol_timer_wheel_advance() call processes every due
+ *   tick and skips empty stretches with per-level occupancy bitmaps
+ * - Periodic timers re-arm from their due tick, so they do not drift
+ * - hol_timer_wheel_ticks_until_next() tells a thread how long it may sleep
+ * - POSIX waiter: one thread sleeps until the next timer tick or until a
+ *   producer notifies it after pushing into a queue it consumes
+ * - Tick source agnostic: SysTick counter, RTOS ticks or a monotonic clock
+ *
+ * @section Usage_Example
+ * @code
+ * #include "HOL_TimerWheel.h"
+ *
+ * static hol_timer_wheel_t wheel;
+ * static hol_timer_t flush_timer, retry_timer;
+ *
+ * static void on_flush(hol_timer_t* timer, void* ctx) { (void)timer; (void)ctx; APP_log_flush(0); }
+ * static void on_retry(hol_timer_t* timer, void* ctx) { resend((request_t*)ctx); }
+ *
+ * hol_timer_wheel_init(&wheel, systick_ms());
+ * hol_timer_init(&flush_timer, on_flush, NULL);
+ * hol_timer_start(&wheel, &flush_timer, 100, 100);   // Every 100 ticks
+ * hol_timer_init(&retry_timer, on_retry, &request);
+ * hol_timer_start(&wheel, &retry_timer, 250, 0);     // Once, in 250 ticks
+ * hol_timer_cancel(&wheel, &retry_timer);            // Reply arrived first
+ *
+ * // Main loop / timer thread
+ * hol_timer_wheel_advance(&wheel, systick_ms());     // Runs every due callback
+ * @endcode
+ *
+ * @warning Not thread safe, like HOL_Queue: start, cancel and advance belong to
+ *          one thread (callbacks run on it). Other threads hand work over
+ *          through a queue and hol_timer_waiter_notify().
+ */
+
+#ifndef HOL_TIMER_WHEEL_H
+#define HOL_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* ==================== CONFIGURATION ==================== */
+
+/**
+ * @brief Wheel levels (1..5); range = 64^LEVELS ticks
+ * @note Longer delays still work: they sit in the top level and are
+ *       re-filed when that slot cascades. Delays must stay below 2^31 ticks.
+ */
+#ifndef HOL_TIMER_WHEEL_LEVELS
+#define HOL_TIMER_WHEEL_LEVELS 4
+#endif
+
+#if HOL_TIMER_WHEEL_LEVELS < 1 || HOL_TIMER_WHEEL_LEVELS > 5
+#error "HOL_TIMER_WHEEL_LEVELS must be 1..5"
+#endif
+
+/**
+ * @brief Build the POSIX waiter (pthread mutex + condition variable)
+ */
+#ifndef HOL_TIMER_WHEEL_POSIX
+#if defined(__unix__) || defined(__APPLE__)
+#define HOL_TIMER_WHEEL_POSIX 1
+#else
+#define HOL_TIMER_WHEEL_POSIX 0
+#endif
+#endif
+
+#define HOL_TIMER_WHEEL_BITS  6
+#define HOL_TIMER_WHEEL_SLOTS 64
+#define HOL_TIMER_WHEEL_MASK  63u
+
+/**
+ * @brief Returned by hol_timer_wheel_ticks_until_next() when no timer is pending
+ */
+#define HOL_TIMER_NEVER UINT32_MAX
+
+/* Timer is in the list of the tick being processed */
+#define HOL_TIMER_LEVEL_EXPIRING 0xFFu
+
+/* ==================== TYPES ==================== */
+
+typedef struct hol_timer hol_timer_t;
+
+/**
+ * @brief Expiry callback; may start or cancel any timer, including this one
+ */
+typedef void (*hol_timer_fn_t)(hol_timer_t* timer, void* ctx);
+
+/**
+ * @brief Timer node (caller-owned, static storage)
+ */
+struct hol_timer {
+    hol_timer_t*   next;
+    hol_timer_t**  pprev;                     /* NULL when not pending */
+    uint32_t       expires;                   /* Absolute tick */
+    uint32_t       period;                    /* 0 = one-shot */
+    hol_timer_fn_t fn;
+    void*          ctx;
+    uint8_t        level;
+    uint8_t        slot;
+};
+
+typedef struct {
+    hol_timer_t* slots[HOL_TIMER_WHEEL_LEVELS][HOL_TIMER_WHEEL_SLOTS];
+    uint64_t     occupied[HOL_TIMER_WHEEL_LEVELS];   /* Bit per non-empty slot */
+    hol_timer_t* expiring;                    /* Timers of the tick being processed */
+    uint32_t     now;                         /* Last processed tick */
+    uint32_t     pending;                     /* Started and not yet fired / cancelled */
+} hol_timer_wheel_t;
+
+/* ==================== INTERNALS ==================== */
+
+static inline unsigned hol_timer_ctz64(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_ctzll(value);
+#else
+    unsigned n = 0;
+    while ((value & 1u) == 0) { value >>= 1; n++; }
+    return n;
+#endif
+}
+
+/* Distance (1..64) from slot index base to the first occupied slot, cyclically; bits != 0 */
+static inline uint32_t hol_timer_first_slot(uint64_t bits, uint32_t base)
+{
+    unsigned r = base & HOL_TIMER_WHEEL_MASK;
+    uint64_t rotated = (r == 0) ? bits : ((bits >> r) | (bits << (64u - r)));
+    return hol_timer_ctz64(rotated);
+}
+
+static inline void hol_timer_link(hol_timer_wheel_t* wheel, hol_timer_t* timer)
+{
+    uint32_t delta = timer->expires - wheel->now;
+    unsigned level = 0;
+    while (level + 1 < HOL_TIMER_WHEEL_LEVELS &&
+           delta >= ((uint32_t)1 << (HOL_TIMER_WHEEL_BITS * (level + 1))))
+    {
+        level++;
+    }
+    unsigned slot = (timer->expires >> (HOL_TIMER_WHEEL_BITS * level)) & HOL_TIMER_WHEEL_MASK;
+
+    hol_timer_t** head = &wheel->slots[level][slot];
+    timer->next = *head;
+    if (timer->next) { timer->next->pprev = &timer->next; }
+    *head = timer;
+    timer->pprev = head;
+    timer->level = (uint8_t)level;
+    timer->slot = (uint8_t)slot;
+    wheel->occupied[level] |= (uint64_t)1 << slot;
+}
+
+static inline void hol_timer_unlink(hol_timer_wheel_t* wheel, hol_timer_t* timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next) { timer->next->pprev = timer->pprev; }
+    if (timer->level != HOL_TIMER_LEVEL_EXPIRING && !wheel->slots[timer->level][timer->slot])
+    {
+        wheel->occupied[timer->level] &= ~((uint64_t)1 << timer->slot);
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/* Re-file every timer of a higher-level slot relative to the current tick */
+static inline void hol_timer_cascade(hol_timer_wheel_t* wheel, unsigned level, unsigned slot)
+{
+    hol_timer_t* timer = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~((uint64_t)1 << slot);
+    while (timer)
+    {
+        hol_timer_t* next = timer->next;
+        hol_timer_link(wheel, timer);
+        timer = next;
+    }
+}
+
+/* Process tick now + 1: cascade, then run the timers due on it */
+static inline size_t hol_timer_wheel_tick(hol_timer_wheel_t* wheel)
+{
+    uint32_t tick = ++wheel->now;
+    for (unsigned level = 1; level < HOL_TIMER_WHEEL_LEVELS; level++)
+    {
+        if (tick & (((uint32_t)1 << (HOL_TIMER_WHEEL_BITS * level)) - 1u)) { break; }
+        unsigned slot = (tick >> (HOL_TIMER_WHEEL_BITS * level)) & HOL_TIMER_WHEEL_MASK;
+        hol_timer_cascade(wheel, level, slot);
+    }
+
+    unsigned slot = tick & HOL_TIMER_WHEEL_MASK;
+    hol_timer_t* batch = wheel->slots[0][slot];
+    if (!batch) { return 0; }
+    wheel->slots[0][slot] = NULL;
+    wheel->occupied[0] &= ~((uint64_t)1 << slot);
+    wheel->expiring = batch;
+    batch->pprev = &wheel->expiring;
+    for (hol_timer_t* t = batch; t; t = t->next) { t->level = HOL_TIMER_LEVEL_EXPIRING; }
+
+    size_t fired = 0;
+    hol_timer_t* timer;
+    while ((timer = wheel->expiring) != NULL)   /* A callback may cancel timers still in the list */
+    {
+        hol_timer_unlink(wheel, timer);
+        wheel->pending--;
+        if (timer->period != 0)
+        {
+            timer->expires = tick + timer->period;
+            hol_timer_link(wheel, timer);
+            wheel->pending++;
+        }
+        timer->fn(timer, timer->ctx);
+        fired++;
+    }
+    return fired;
+}
+
+/* ==================== API ==================== */
+
+/**
+ * @brief Prepare a timer (not pending)
+ */
+static inline void hol_timer_init(hol_timer_t* timer, hol_timer_fn_t fn, void* ctx)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->fn = fn;
+    timer->ctx = ctx;
+}
+
+static inline bool hol_timer_pending(const hol_timer_t* timer)
+{
+    return timer->pprev != NULL;
+}
+
+/**
+ * @brief Empty wheel whose current time is now_ticks
+ */
+static inline void hol_timer_wheel_init(hol_timer_wheel_t* wheel, uint32_t now_ticks)
+{
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->now = now_ticks;
+}
+
+/**
+ * @brief Cancel a pending timer
+ * @return true if it was pending
+ */
+static inline bool hol_timer_cancel(hol_timer_wheel_t* wheel, hol_timer_t* timer)
+{
+    if (!timer->pprev) { return false; }
+    hol_timer_unlink(wheel, timer);
+    wheel->pending--;
+    return true;
+}
+
+/**
+ * @brief Start (or restart) a timer
+ * @param delay_ticks  Ticks from the wheel's current time (0 behaves as 1: next tick)
+ * @param period_ticks Re-arm interval after each expiry (0 = one-shot)
+ */
+static inline void hol_timer_start(hol_timer_wheel_t* wheel, hol_timer_t* timer,
+                                   uint32_t delay_ticks, uint32_t period_ticks)
+{
+    (void)hol_timer_cancel(wheel, timer);
+    timer->expires = wheel->now + (delay_ticks ? delay_ticks : 1u);
+    timer->period = period_ticks;
+    hol_timer_link(wheel, timer);
+    wheel->pending++;
+}
+
+/**
+ * @brief Ticks from the current time to the next tick with work (1.. or HOL_TIMER_NEVER)
+ * @note The tick may be a cascade rather than an expiry, so waking then can
+ *       be early (nothing fires) but never late.
+ */
+static inline uint32_t hol_timer_wheel_ticks_until_next(const hol_timer_wheel_t* wheel)
+{
+    if (wheel->pending == 0) { return HOL_TIMER_NEVER; }
+    uint32_t best = HOL_TIMER_NEVER;
+    if (wheel->occupied[0])
+    {
+        best = 1u + hol_timer_first_slot(wheel->occupied[0], wheel->now + 1u);
+    }
+    for (unsigned level = 1; level < HOL_TIMER_WHEEL_LEVELS; level++)
+    {
+        if (!wheel->occupied[level]) { continue; }
+        unsigned shift = HOL_TIMER_WHEEL_BITS * level;
+        uint32_t boundary = (wheel->now >> shift) + 1u;        /* First boundary after now */
+        uint32_t at = (boundary + hol_timer_first_slot(wheel->occupied[level], boundary)) << shift;
+        uint32_t distance = at - wheel->now;
+        if (distance < best) { best = distance; }
+    }
+    if (wheel->expiring && best > 1u) { best = 1u; }
+    return best;
+}
+
+/**
+ * @brief Process every tick up to and including now_ticks; runs due callbacks
+ * @return Callbacks run
+ */
+static inline size_t hol_timer_wheel_advance(hol_timer_wheel_t* wheel, uint32_t now_ticks)
+{
+    size_t fired = 0;
+    if ((int32_t)(now_ticks - wheel->now) <= 0) { return 0; }
+    while (wheel->pending != 0)
+    {
+        uint32_t step = hol_timer_wheel_ticks_until_next(wheel);
+        if ((int32_t)(now_ticks - wheel->now) <= 0 || step > now_ticks - wheel->now) { break; }
+        wheel->now += step - 1u;                              /* Skip ticks without work */
+        fired += hol_timer_wheel_tick(wheel);
+    }
+    if ((int32_t)(now_ticks - wheel->now) > 0) { wheel->now = now_ticks; }
+    return fired;
+}
+
+/* ==================== POSIX WAITER ==================== */
+
+#if HOL_TIMER_WHEEL_POSIX
+
+#include <time.h>
+#include <pthread.h>
+
+/**
+ * @brief Lets one thread sleep until the next timer tick or the next queue item
+ *
+ * Consumer thread:
+ *   for (;;) {
+ *       while (queue_pull_job_t_64(&jobs, &job) == QUEUE_job_t_64_OK) { handle(&job); }
+ *       hol_timer_wheel_advance(&wheel, hol_timer_waiter_ticks(&waiter));
+ *       hol_timer_wait(&wheel, &waiter);
+ *   }
+ * Producer thread, after its push (under the queue's lock, if it has one):
+ *   hol_timer_waiter_notify(&waiter);
+ *
+ * A notify that arrives while the consumer drains the queue makes the next
+ * wait return at once, so no item waits for a timer to wake the thread.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    clockid_t       clock;
+    uint64_t        tick_ns;
+    uint64_t        origin_ns;
+    int             waiting;                  /* Consumer is inside hol_timer_wait() */
+    int             signalled;                /* Notified since the last wait returned */
+} hol_timer_waiter_t;
+
+static inline uint64_t hol_timer_waiter_clock_ns(const hol_timer_waiter_t* waiter)
+{
+    struct timespec ts;
+    clock_gettime(waiter->clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Prepare a waiter; one tick lasts tick_ns nanoseconds
+ */
+static inline void hol_timer_waiter_init(hol_timer_waiter_t* waiter, uint64_t tick_ns)
+{
+    memset(waiter, 0, sizeof(*waiter));
+    pthread_mutex_init(&waiter->lock, NULL);
+    waiter->clock = CLOCK_REALTIME;
+#if !defined(__APPLE__)
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    if (pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0) { waiter->clock = CLOCK_MONOTONIC; }
+    pthread_cond_init(&waiter->cond, &attr);
+    pthread_condattr_destroy(&attr);
+#else
+    pthread_cond_init(&waiter->cond, NULL);
+#endif
+    waiter->tick_ns = tick_ns ? tick_ns : 1;
+    waiter->origin_ns = hol_timer_waiter_clock_ns(waiter);
+}
+
+/**
+ * @brief Current time in ticks (0 at hol_timer_waiter_init(); wraps at 2^32)
+ */
+static inline uint32_t hol_timer_waiter_ticks(const hol_timer_waiter_t* waiter)
+{
+    return (uint32_t)((hol_timer_waiter_clock_ns(waiter) - waiter->origin_ns) / waiter->tick_ns);
+}
+
+/**
+ * @brief Wake the waiting thread (any thread, after publishing work)
+ * @note Costs one atomic exchange; the lock is taken only if the consumer sleeps.
+ */
+static inline void hol_timer_waiter_notify(hol_timer_waiter_t* waiter)
+{
+    if (__atomic_exchange_n(&waiter->signalled, 1, __ATOMIC_SEQ_CST) != 0) { return; }
+    if (__atomic_load_n(&waiter->waiting, __ATOMIC_SEQ_CST))
+    {
+        pthread_mutex_lock(&waiter->lock);
+        pthread_cond_signal(&waiter->cond);
+        pthread_mutex_unlock(&waiter->lock);
+    }
+}
+
+/**
+ * @brief Sleep until the wheel's next tick with work, or until notified
+ * @return true if woken by hol_timer_waiter_notify() (or already notified)
+ */
+static inline bool hol_timer_wait(const hol_timer_wheel_t* wheel, hol_timer_waiter_t* waiter)
+{
+    pthread_mutex_lock(&waiter->lock);
+    __atomic_store_n(&waiter->waiting, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&waiter->signalled, __ATOMIC_SEQ_CST))
+    {
+        uint32_t until = hol_timer_wheel_ticks_until_next(wheel);
+        if (until == HOL_TIMER_NEVER)
+        {
+            pthread_cond_wait(&waiter->cond, &waiter->lock);
+        }
+        else
+        {
+            /* Absolute time of tick (wheel->now + until), measured from the waiter's origin */
+            uint64_t now_ns = hol_timer_waiter_clock_ns(waiter);
+            uint64_t elapsed = (now_ns - waiter->origin_ns) / waiter->tick_ns;
+            int64_t ahead = (int32_t)(wheel->now + until - (uint32_t)elapsed);
+            uint64_t deadline = waiter->origin_ns +
+                                (uint64_t)((int64_t)elapsed + ahead) * waiter->tick_ns;
+            if (deadline > now_ns)
+            {
+                struct timespec ts;
+                ts.tv_sec = (time_t)(deadline / 1000000000ull);
+                ts.tv_nsec = (long)(deadline % 1000000000ull);
+                (void)pthread_cond_timedwait(&waiter->cond, &waiter->lock, &ts);
+            }
+        }
+    }
+    __atomic_store_n(&waiter->waiting, 0, __ATOMIC_SEQ_CST);
+    bool notified = __atomic_exchange_n(&waiter->signalled, 0, __ATOMIC_SEQ_CST) != 0;
+    pthread_mutex_unlock(&waiter->lock);
+    return notified;
+}
+
+#endif /* HOL_TIMER_WHEEL_POSIX */
+
+#endif /* HOL_TIMER_WHEEL_H */
@@ -0,0 +1,207 @@
+#!/bin/sh
+#
+# hol_footprint.sh - Code and RAM footprint per DECLARE_QUEUE / DECLARE_LOG instantiation
+#
+# Compiles a manifest of instantiations into one object file, then groups the
+# symbols by the instantiation that generated them and reports .text, .rodata,
+# .data and .bss per group. The same manifest is built once per size mode
+# (compiler flags), so the savings of each mode show up side by side.
+#
+# Usage:
+#   hol_footprint.sh [-a] [-v] [-c cc] [-f "base flags"] [-m "name=flags"]... manifest
+#
+#   -a   Print the per-group table for every mode, not only the baseline
+#   -v   List every symbol under its group
+#   -c   Compiler (default: $CC or gcc; GCC is needed for -fkeep-inline-functions)
+#   -f   Flags shared by every mode (default: -Os)
+#   -m   Add a mode; the first mode is the baseline. Without -m the built-in
+#        modes below are compared.
+#
+# Manifest: a C fragment, one instantiation per line; // comments, #define and
+# #include lines pass through unchanged. Example:
+#
+#   DECLARE_QUEUE(u8, 64)
+#   DECLARE_STRING_QUEUE(32, 8)
+#   DECLARE_LOG(APP, 128, void)
+#   DECLARE_LOG(NET, 128, void)
+#   DECLARE_LOG_DEFERRED(NET, 128, 16)      // Add-ons need their DECLARE_LOG
+#   DECLARE_LOG_RECENT(NET, 8, 96)
+#
+# Add-ons (DECLARE_LOG_DEFERRED, _DEFERRED_PERCPU, _RECENT) are reported as
+# their own group, separate from the TAG's DECLARE_LOG functions.
+#
+# Every generated function is emitted out of line (-fkeep-inline-functions),
+# so the figures are the cost with the whole API in use and nothing inlined:
+# an upper bound for code, exact for RAM. Each DECLARE_QUEUE also gets one
+# instance, so .bss shows sizeof() of the queue including padding.
+
+set -eu
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CC_BIN=${CC:-gcc}
+BASE_FLAGS="-Os"
+VERBOSE=0
+ALL_MODES=0
+MODES=""
+
+usage() {
+    echo "usage: $0 [-a] [-v] [-c cc] [-f \"base flags\"] [-m \"name=flags\"]... manifest" >&2
+    exit 2
+}
+
+while getopts "avc:f:m:" opt; do
+    case $opt in
+        a) ALL_MODES=1 ;;
+        v) VERBOSE=1 ;;
+        c) CC_BIN=$OPTARG ;;
+        f) BASE_FLAGS=$OPTARG ;;
+        m) MODES="$MODES$OPTARG
+" ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+[ $# -eq 1 ] || usage
+MANIFEST=$1
+[ -r "$MANIFEST" ] || { echo "$MANIFEST: cannot read" >&2; exit 1; }
+
+if [ -z "$MODES" ]; then
+    MODES="default=
+stack-constrained=-DLOG_INTERNAL_BUFFER=64
+O2=-O2
+queue-stats=-DQUEUE_ENABLE_STATS=1
+"
+fi
+
+WS='[[:space:]]'
+ID='\([A-Za-z0-9_]*\)'
+NUM='\([0-9]*\)'
+
+WORK=$(mktemp -d "${TMPDIR:-/tmp}/hol_footprint.XXXXXX")
+trap 'rm -rf "$WORK"' EXIT INT TERM
+
+# ---- Generate the translation unit and the group patterns ----------------------------------
+
+{
+    echo '#include "HOL_Queue.h"'
+    echo '#include "HOL_Logger.h"'
+    cat "$MANIFEST"
+    echo
+    # One instance per queue, so its RAM (with padding) appears in .bss
+    sed -n \
+        -e "s/^$WS*DECLARE_QUEUE($WS*$ID$WS*,$WS*$NUM$WS*).*/queue_\1_\2_t queue_instance_\1_\2;/p" \
+        -e "s/^$WS*DECLARE_STRING_QUEUE($WS*$NUM$WS*,$WS*$NUM$WS*).*/queue_str_\1_\2_t queue_instance_str_\1_\2;/p" \
+        "$MANIFEST"
+} > "$WORK/manifest.c"
+
+# group name <TAB> extended regex on symbol names <TAB> priority (highest matching pattern wins)
+sed -n \
+    -e "s/^$WS*DECLARE_QUEUE($WS*$ID$WS*,$WS*$NUM$WS*).*/queue \1\/\2	^queue_.*_\1_\2(_t)?\$	0/p" \
+    -e "s/^$WS*DECLARE_STRING_QUEUE($WS*$NUM$WS*,$WS*$NUM$WS*).*/string queue \1\/\2	^queue_.*_(str_)?\1_\2(_t)?\$	0/p" \
+    -e "s/^$WS*DECLARE_LOG($WS*$ID$WS*,.*/log \1	^\1_	0/p" \
+    -e "s/^$WS*DECLARE_LOG_DEFERRED($WS*$ID$WS*,.*/log \1 deferred	^\1_log_(deferred_|lane|flush|drop_count)	1/p" \
+    -e "s/^$WS*DECLARE_LOG_DEFERRED_PERCPU($WS*$ID$WS*,.*/log \1 deferred per-CPU	^\1_log_(deferred_|lane|shards|flush|drop_count|busy_drops)	1/p" \
+    -e "s/^$WS*DECLARE_LOG_RECENT($WS*$ID$WS*,.*/log \1 recent	^\1_log_recent_	1/p" \
+    "$MANIFEST" > "$WORK/groups"
+printf 'shared logger core\t^hol_log_\t0\n' >> "$WORK/groups"
+
+# ---- Build and measure one mode ------------------------------------------------------------
+
+# Prints: text rodata data bss (section totals of the object file)
+section_totals() {
+    size -A "$1" | awk '
+        $1 ~ /^\.text/                       { t += $2 }
+        $1 ~ /^\.rodata/                     { r += $2 }
+        $1 ~ /^\.(data|sdata|tdata)/         { d += $2 }
+        $1 ~ /^\.(bss|sbss|tbss)/            { b += $2 }
+        END { printf "%d %d %d %d\n", t, r, d, b }'
+}
+
+# Per-group table from nm; unattributed bytes (string literals, ...) come from section totals
+group_report() {
+    obj=$1
+    nm -S --defined-only "$obj" > "$WORK/nm.txt"
+    totals=$(section_totals "$obj")
+    awk -F '\t' -v verbose="$VERBOSE" -v totals="$totals" '
+        function hex(s,    i, v) {
+            v = 0
+            for (i = 1; i <= length(s); i++) { v = v * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1 }
+            return v
+        }
+        BEGIN { n = 0 }
+        FNR == NR { name[n] = $1; pattern[n] = $2; prio[n] = $3; n++; next }
+        {
+            split($0, f, " ")
+            if (f[4] == "") { next }                       # No size: label or absolute symbol
+            size = hex(tolower(f[2])); type = f[3]; sym = f[4]
+            if      (type ~ /[TtWw]/)   { col = 1 }
+            else if (type ~ /[Rr]/)     { col = 2 }
+            else if (type ~ /[DdVvGg]/) { col = 3 }
+            else if (type ~ /[BbSs]/)   { col = 4 }
+            else { next }
+            g = n
+            for (i = 0; i < n; i++) {
+                if (sym ~ pattern[i] && (g == n || prio[i] > prio[g])) { g = i }
+            }
+            sum[g, col] += size; all[col] += size
+            syms[g] = syms[g] sprintf("      %-44s %6d %s\n", sym, size, type)
+        }
+        END {
+            printf "%-36s %8s %8s %8s %8s\n", "group", ".text", ".rodata", ".data", ".bss"
+            name[n] = "other (headers, instances)"
+            split(totals, tot, " ")
+            for (i = 0; i <= n; i++) {
+                if (i == n && sum[i,1] + sum[i,2] + sum[i,3] + sum[i,4] == 0) { continue }
+                printf "%-36s %8d %8d %8d %8d\n", name[i], sum[i,1], sum[i,2], sum[i,3], sum[i,4]
+                if (verbose == 1) { printf "%s", syms[i] }
+            }
+            printf "%-36s %8d %8d %8d %8d\n", "unattributed (literals, padding)",
+                   tot[1] - all[1], tot[2] - all[2], tot[3] - all[3], tot[4] - all[4]
+            printf "%-36s %8d %8d %8d %8d\n", "total", tot[1], tot[2], tot[3], tot[4]
+        }' "$WORK/groups" "$WORK/nm.txt"
+}
+
+compile() {
+    # $1 = output object, remaining = extra flags
+    out=$1; shift
+    # shellcheck disable=SC2086
+    "$CC_BIN" $BASE_FLAGS "$@" -c -fkeep-inline-functions -ffunction-sections -fdata-sections \
+        -I"$ROOT/Queue" -I"$ROOT/Logger" "$WORK/manifest.c" -o "$out"
+}
+
+# ---- Run every mode --------------------------------------------------------------------------
+
+printf '%s\n' "$MODES" | {
+    first=1
+    base_flash=0
+    base_ram=0
+    summary=""
+    while IFS= read -r mode; do
+        [ -n "$mode" ] || continue
+        mname=${mode%%=*}
+        mflags=${mode#*=}
+        obj="$WORK/$mname.o"
+        # shellcheck disable=SC2086
+        if ! compile "$obj" $mflags 2> "$WORK/$mname.err"; then
+            echo "mode $mname: build failed (see below), skipped" >&2
+            sed 's/^/    /' "$WORK/$mname.err" | head -n 8 >&2
+            continue
+        fi
+        if [ $first -eq 1 ] || [ $ALL_MODES -eq 1 ]; then
+            echo "== $mname ($BASE_FLAGS${mflags:+ $mflags}) =="
+            group_report "$obj"
+            echo
+        fi
+        set -- $(section_totals "$obj")
+        flash=$(($1 + $2 + $3))
+        ram=$(($3 + $4))
+        if [ $first -eq 1 ]; then base_flash=$flash; base_ram=$ram; first=0; fi
+        summary="$summary$(printf '%-20s %8d %8d %8d %8d %9d %+9d %+8d' "$mname" "$1" "$2" "$3" "$4" \
+            "$flash" $((flash - base_flash)) $((ram - base_ram)))
+"
+    done
+    echo "== modes (flash = .text + .rodata + .data, RAM = .data + .bss) =="
+    printf '%-20s %8s %8s %8s %8s %9s %9s %8s\n' \
+        "mode" ".text" ".rodata" ".data" ".bss" "flash" "+flash" "+RAM"
+    printf '%s' "$summary"
+}
@@ -0,0 +1,513 @@
+/**
+ * @file hol_log_decode.c
+ * @brief Offline decoder for HOL_Logger binary streams
+ *
+ * Turns files written through TAG_set_binary_stream() back into the same text
+ * lines the logger prints in text mode: "[L] (TAG): message".
+ *
+ * Build:
+ *   cc -O2 -I../Logger -o hol_log_decode hol_log_decode.c
+ *
+ * Usage:
+ *   hol_log_decode <binary_log> [output_text]      (default output: stdout)
+ *
+ * Format strings are compiled once, when their definition record is read,
+ * into a list of literal and conversion operations. Plain %d/%u/%x/%s
+ * conversions are rendered without snprintf and output is written in large
+ * blocks, so throughput is bounded by memory bandwidth rather than stdio.
+ *
+ * @note Assumes the file was written by a little-endian target (doubles are
+ *       stored in host order by the encoder).
+ */
+
+#include "HOL_Logger.h"
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define OUT_BUFFER_SIZE   (1u << 20)
+#define OUT_LINE_RESERVE  (1u << 16)   /* Largest single line we may append */
+#define MAX_IDS           0x10000u
+
+typedef enum {
+    OP_LITERAL = 0,
+    OP_INT_FAST,      /* "%d" / "%i" */
+    OP_UINT_FAST,     /* "%u" */
+    OP_HEX_FAST,      /* "%x" */
+    OP_STR_FAST,      /* "%s" */
+    OP_SIGNED,
+    OP_UNSIGNED,
+    OP_CHAR,
+    OP_POINTER,
+    OP_DOUBLE,
+    OP_STRING,
+    OP_NONE           /* %n: no field */
+} op_kind_e;
+
+typedef struct {
+    uint8_t     kind;
+    uint8_t     modifier;
+    bool        star_width;
+    bool        star_precision;
+    const char* text;        /* Literal text (OP_LITERAL) */
+    size_t      text_len;
+    char        spec[32];    /* Rewritten printf spec for the slow path */
+} op_t;
+
+typedef struct {
+    const char* tag;
+    size_t      tag_len;
+    char*       source;      /* Terminated copy of the format string */
+    op_t*       ops;
+    size_t      op_count;
+} format_t;
+
+static format_t formats[MAX_IDS];
+
+static char   out_buf[OUT_BUFFER_SIZE];
+static size_t out_len;
+static FILE*  out_file;
+
+static void out_flush(void)
+{
+    if (out_len > 0 && fwrite(out_buf, 1, out_len, out_file) != out_len)
+    {
+        perror("write");
+        exit(1);
+    }
+    out_len = 0;
+}
+
+static inline void out_put(const void* data, size_t len)
+{
+    if (len > OUT_BUFFER_SIZE - out_len) { out_flush(); }
+    if (len > OUT_BUFFER_SIZE) { (void)fwrite(data, 1, len, out_file); return; }
+    memcpy(&out_buf[out_len], data, len);
+    out_len += len;
+}
+
+static inline void out_char(char c)
+{
+    if (out_len == OUT_BUFFER_SIZE) { out_flush(); }
+    out_buf[out_len++] = c;
+}
+
+static inline void out_uint(uint64_t v, unsigned base)
+{
+    static const char digits[] = "0123456789abcdef";
+    char tmp[24];
+    size_t n = sizeof(tmp);
+    do
+    {
+        tmp[--n] = digits[v % base];
+        v /= base;
+    } while (v != 0);
+    out_put(&tmp[n], sizeof(tmp) - n);
+}
+
+/* ---------- Payload readers ---------- */
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} reader_t;
+
+static inline bool read_varint(reader_t* r, uint64_t* v)
+{
+    uint64_t result = 0;
+    unsigned shift = 0;
+    while (r->p < r->end && shift < 64)
+    {
+        uint8_t byte = *r->p++;
+        result |= (uint64_t)(byte & 0x7Fu) << shift;
+        if ((byte & 0x80u) == 0) { *v = result; return true; }
+        shift += 7;
+    }
+    return false;
+}
+
+static inline bool read_signed(reader_t* r, int64_t* v)
+{
+    uint64_t z;
+    if (!read_varint(r, &z)) { return false; }
+    *v = (int64_t)(z >> 1) ^ -(int64_t)(z & 1u);
+    return true;
+}
+
+/* ---------- Format compilation ---------- */
+
+static void compile_format(format_t* f, const char* fmt, size_t fmt_len)
+{
+    /* Work on a terminated copy so the shared parser can be used */
+    char* copy = malloc(fmt_len + 1);
+    op_t* ops = malloc(sizeof(op_t) * (fmt_len + 1));
+    if (copy == NULL || ops == NULL) { perror("malloc"); exit(1); }
+    memcpy(copy, fmt, fmt_len);
+    copy[fmt_len] = '\0';
+
+    size_t count = 0;
+    const char* cursor = copy;
+    const char* literal = copy;
+    hol_log_spec_t spec;
+
+    while (hol_log_fmt_next(&cursor, &spec))
+    {
+        if (spec.start > literal)
+        {
+            ops[count] = (op_t){ .kind = OP_LITERAL, .text = literal,
+                                 .text_len = (size_t)(spec.start - literal) };
+            count++;
+        }
+        literal = cursor;
+
+        if (spec.conversion == '%')
+        {
+            ops[count++] = (op_t){ .kind = OP_LITERAL, .text = "%", .text_len = 1 };
+            continue;
+        }
+
+        op_t* op = &ops[count++];
+        memset(op, 0, sizeof(*op));
+        op->modifier = spec.modifier;
+        op->star_width = spec.star_width;
+        op->star_precision = spec.star_precision;
+
+        bool plain = (spec.length == 2);
+        switch (spec.conversion)
+        {
+            case 'd': case 'i': op->kind = plain ? OP_INT_FAST : OP_SIGNED; break;
+            case 'u':           op->kind = plain ? OP_UINT_FAST : OP_UNSIGNED; break;
+            case 'x':           op->kind = plain ? OP_HEX_FAST : OP_UNSIGNED; break;
+            case 'o': case 'X': op->kind = OP_UNSIGNED; break;
+            case 'c':           op->kind = OP_CHAR; break;
+            case 'p':           op->kind = OP_POINTER; break;
+            case 's':           op->kind = plain ? OP_STR_FAST : OP_STRING; break;
+            case 'e': case 'E': case 'f': case 'F':
+            case 'g': case 'G': case 'a': case 'A':
+                                op->kind = OP_DOUBLE; break;
+            case 'n':           op->kind = OP_NONE; break;
+            default:
+                /* Unknown conversion: print it verbatim */
+                op->kind = OP_LITERAL;
+                op->text = spec.start;
+                op->text_len = spec.length;
+                continue;
+        }
+
+        /* Slow-path spec: flags/width/precision, then a modifier matching the
+         * type we pass (long long for integers, none for double/char/pointer) */
+        const char* conv = spec.start + spec.length - 1;
+        const char* body_end = conv;
+        while (body_end > spec.start &&
+               strchr("hlLzjt", body_end[-1]) != NULL) { body_end--; }
+        size_t body = (size_t)(body_end - spec.start);
+        if (body > sizeof(op->spec) - 4) { body = sizeof(op->spec) - 4; }
+        memcpy(op->spec, spec.start, body);
+        if (op->kind == OP_SIGNED || op->kind == OP_UNSIGNED)
+        {
+            op->spec[body++] = 'l';
+            op->spec[body++] = 'l';
+        }
+        op->spec[body++] = *conv;
+        op->spec[body] = '\0';
+    }
+
+    if (*literal != '\0')
+    {
+        ops[count++] = (op_t){ .kind = OP_LITERAL, .text = literal, .text_len = strlen(literal) };
+    }
+
+    free(f->source);
+    free(f->ops);
+    f->source = copy;
+    f->ops = ops;
+    f->op_count = count;
+}
+
+/* ---------- Rendering ---------- */
+
+static uint64_t truncate_unsigned(uint64_t v, uint8_t modifier)
+{
+    switch (modifier)
+    {
+        case HOL_LOG_MOD_HH: return (unsigned char)v;
+        case HOL_LOG_MOD_H:  return (unsigned short)v;
+        default:             return v;
+    }
+}
+
+static int64_t truncate_signed(int64_t v, uint8_t modifier)
+{
+    switch (modifier)
+    {
+        case HOL_LOG_MOD_HH: return (signed char)v;
+        case HOL_LOG_MOD_H:  return (short)v;
+        default:             return v;
+    }
+}
+
+/* snprintf with 0, 1 or 2 leading '*' arguments */
+#define FORMAT_STAR(dst, cap, op, w, p, value)                                      \
+    ((op)->star_width && (op)->star_precision ? snprintf(dst, cap, (op)->spec, w, p, value) \
+     : (op)->star_width                       ? snprintf(dst, cap, (op)->spec, w, value)    \
+     : (op)->star_precision                   ? snprintf(dst, cap, (op)->spec, p, value)    \
+     :                                          snprintf(dst, cap, (op)->spec, value))
+
+static void render_slow(const op_t* op, reader_t* r, int width, int precision, bool* ok)
+{
+    char tmp[512];
+    int n = 0;
+
+    switch (op->kind)
+    {
+        case OP_SIGNED:
+        {
+            int64_t v;
+            if (!(*ok = read_signed(r, &v))) { return; }
+            n = FORMAT_STAR(tmp, sizeof(tmp), op, width, precision,
+                            (long long)truncate_signed(v, op->modifier));
+            break;
+        }
+        case OP_UNSIGNED:
+        {
+            uint64_t v;
+            if (!(*ok = read_varint(r, &v))) { return; }
+            n = FORMAT_STAR(tmp, sizeof(tmp), op, width, precision,
+                            (unsigned long long)truncate_unsigned(v, op->modifier));
+            break;
+        }
+        case OP_CHAR:
+        {
+            uint64_t v;
+            if (!(*ok = read_varint(r, &v))) { return; }
+            n = FORMAT_STAR(tmp, sizeof(tmp), op, width, precision, (int)v);
+            break;
+        }
+        case OP_POINTER:
+        {
+            uint64_t v;
+            if (!(*ok = read_varint(r, &v))) { return; }
+            n = FORMAT_STAR(tmp, sizeof(tmp), op, width, precision, (void*)(uintptr_t)v);
+            break;
+        }
+        case OP_DOUBLE:
+        {
+            double v;
+            if (!(*ok = (size_t)(r->end - r->p) >= sizeof(v))) { return; }
+            memcpy(&v, r->p, sizeof(v));
+            r->p += sizeof(v);
+            n = FORMAT_STAR(tmp, sizeof(tmp), op, width, precision, v);
+            break;
+        }
+        case OP_STRING:
+        {
+            uint64_t len;
+            char str[LOG_INTERNAL_BUFFER > 256 ? LOG_INTERNAL_BUFFER : 256];
+            if (!(*ok = read_varint(r, &len) && len <= (uint64_t)(r->end - r->p))) { return; }
+            size_t keep = (len < sizeof(str)) ? (size_t)len : sizeof(str) - 1;
+            memcpy(str, r->p, keep);
+            str[keep] = '\0';
+            r->p += len;
+            n = FORMAT_STAR(tmp, sizeof(tmp), op, width, precision, str);
+            break;
+        }
+        default:
+            return;
+    }
+
+    if (n > 0) { out_put(tmp, ((size_t)n < sizeof(tmp)) ? (size_t)n : sizeof(tmp) - 1); }
+}
+
+static void render_record(const format_t* f, int level, bool truncated,
+                          const uint8_t* payload, size_t payload_len)
+{
+    static const char level_chars[] = "DIWE";
+    reader_t r = { payload, payload + payload_len };
+    bool ok = true;
+
+    out_char('[');
+    out_char((level >= 0 && level < 4) ? level_chars[level] : '?');
+    out_put("] (", 3);
+    out_put(f->tag, f->tag_len);
+    out_put("): ", 3);
+
+    for (size_t i = 0; ok && i < f->op_count; i++)
+    {
+        const op_t* op = &f->ops[i];
+        int64_t width = 0;
+        int64_t precision = 0;
+
+        if (op->kind == OP_LITERAL) { out_put(op->text, op->text_len); continue; }
+        if (op->star_width && !(ok = read_signed(&r, &width))) { break; }
+        if (op->star_precision && !(ok = read_signed(&r, &precision))) { break; }
+
+        switch (op->kind)
+        {
+            case OP_INT_FAST:
+            {
+                int64_t v;
+                if (!(ok = read_signed(&r, &v))) { break; }
+                v = truncate_signed(v, op->modifier);
+                if (v < 0) { out_char('-'); out_uint(0u - (uint64_t)v, 10); }
+                else       { out_uint((uint64_t)v, 10); }
+                break;
+            }
+            case OP_UINT_FAST:
+            case OP_HEX_FAST:
+            {
+                uint64_t v;
+                if (!(ok = read_varint(&r, &v))) { break; }
+                out_uint(truncate_unsigned(v, op->modifier), op->kind == OP_HEX_FAST ? 16u : 10u);
+                break;
+            }
+            case OP_STR_FAST:
+            {
+                uint64_t len;
+                if (!(ok = read_varint(&r, &len) && len <= (uint64_t)(r.end - r.p))) { break; }
+                out_put(r.p, (size_t)len);
+                r.p += len;
+                break;
+            }
+            case OP_NONE:
+                break;
+            default:
+                render_slow(op, &r, (int)width, (int)precision, &ok);
+                break;
+        }
+    }
+
+    if (truncated || !ok) { out_put(" [truncated]", 12); }
+    out_char('\n');
+    if (out_len > OUT_BUFFER_SIZE - OUT_LINE_RESERVE) { out_flush(); }
+}
+
+/* ---------- Record loop ---------- */
+
+static int decode(const uint8_t* data, size_t size)
+{
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+
+    while (p < end)
+    {
+        size_t left = (size_t)(end - p);
+
+        switch (p[0])
+        {
+            case 'H':   /* Stream header: a new table starts */
+            {
+                if (left < 5 || memcmp(p, "HOLB", 4) != 0) { goto corrupt; }
+                if (p[4] != LOG_BINARY_VERSION)
+                {
+                    fprintf(stderr, "unsupported stream version %u\n", p[4]);
+                    return 1;
+                }
+                for (size_t i = 0; i < MAX_IDS; i++)
+                {
+                    free(formats[i].source);
+                    free(formats[i].ops);
+                    formats[i].source = NULL;
+                    formats[i].ops = NULL;
+                }
+                p += 5;
+                break;
+            }
+            case LOG_BINARY_REC_DEF:
+            {
+                if (left < 4) { goto corrupt; }
+                unsigned id = (unsigned)p[1] | ((unsigned)p[2] << 8);
+                size_t tag_len = p[3];
+                if (left < 6 + tag_len) { goto corrupt; }
+                const uint8_t* tag = p + 4;
+                size_t fmt_len = (size_t)tag[tag_len] | ((size_t)tag[tag_len + 1] << 8);
+                const uint8_t* fmt = tag + tag_len + 2;
+                if ((size_t)(end - fmt) < fmt_len) { goto corrupt; }
+                formats[id].tag = (const char*)tag;
+                formats[id].tag_len = tag_len;
+                compile_format(&formats[id], (const char*)fmt, fmt_len);
+                p = fmt + fmt_len;
+                break;
+            }
+            case LOG_BINARY_REC_LOG:
+            {
+                if (left < 6) { goto corrupt; }
+                unsigned id = (unsigned)p[2] | ((unsigned)p[3] << 8);
+                size_t payload_len = (size_t)p[4] | ((size_t)p[5] << 8);
+                if (left < 6 + payload_len) { goto corrupt; }
+                if (formats[id].ops == NULL)
+                {
+                    fprintf(stderr, "record uses undefined format id %u\n", id);
+                }
+                else
+                {
+                    render_record(&formats[id], p[1] & ~LOG_BINARY_TRUNCATED & 0xFF,
+                                  (p[1] & LOG_BINARY_TRUNCATED) != 0, p + 6, payload_len);
+                }
+                p += 6 + payload_len;
+                break;
+            }
+            case LOG_BINARY_REC_TEXT:
+            {
+                static const char level_chars[] = "DIWE";
+                if (left < 3) { goto corrupt; }
+                size_t tag_len = p[2];
+                if (left < 5 + tag_len) { goto corrupt; }
+                const uint8_t* tag = p + 3;
+                size_t text_len = (size_t)tag[tag_len] | ((size_t)tag[tag_len + 1] << 8);
+                const uint8_t* text = tag + tag_len + 2;
+                if ((size_t)(end - text) < text_len) { goto corrupt; }
+                out_char('[');
+                out_char(p[1] < 4 ? level_chars[p[1]] : '?');
+                out_put("] (", 3);
+                out_put(tag, tag_len);
+                out_put("): ", 3);
+                out_put(text, text_len);
+                out_char('\n');
+                p = text + text_len;
+                break;
+            }
+            default:
+                goto corrupt;
+        }
+    }
+    return 0;
+
+corrupt:
+    out_flush();
+    fprintf(stderr, "corrupt record at offset %zu\n", (size_t)(p - data));
+    return 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: %s <binary_log> [output_text]\n", argv[0]);
+        return 2;
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) { perror(argv[1]); return 1; }
+
+    out_file = (argc == 3) ? fopen(argv[2], "wb") : stdout;
+    if (out_file == NULL) { perror(argv[2]); return 1; }
+
+    int rc = 0;
+    if (st.st_size > 0)
+    {
+        const uint8_t* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) { perror("mmap"); return 1; }
+        (void)madvise((void*)data, (size_t)st.st_size, MADV_SEQUENTIAL);
+        rc = decode(data, (size_t)st.st_size);
+        munmap((void*)data, (size_t)st.st_size);
+    }
+
+    out_flush();
+    if (out_file != stdout) { fclose(out_file); }
+    close(fd);
+    return rc;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file hol_log_query.c
+ * @brief Time-bounded reads of large HOL_Logger files through their sidecar index
+ *
+ * Binary-searches the index written by HOL_LogFile.h and memory-maps only the
+ * byte range covering the requested time window, so a query over a 50 GB
+ * file touches megabytes instead of gigabytes.
+ *
+ * Build:
+ *   cc -O2 -I../Logger -o hol_log_query hol_log_query.c
+ *
+ * Usage:
+ *   hol_log_query [-c] <log_file> <index_file> <from_ms> <to_ms>
+ *
+ *   -c   Print per-level line counts for the window instead of the lines
+ *
+ * The window is widened to index granularity: output starts at the last
+ * index entry at or before from_ms and ends at the first entry after to_ms.
+ * Compressed logs (hol_log_file_open_compressed) are decoded block by block.
+ */
+
+#define LOG_FILE_COMPRESSION 1
+#include "HOL_LogFile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef struct {
+    const uint8_t* entries;
+    size_t         count;
+    uint32_t       flags;
+} index_t;
+
+static int index_load(const char* path, index_t* index, size_t* mapped_size)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) { perror(path); return -1; }
+
+    if ((size_t)st.st_size < LOG_FILE_INDEX_HEADER_SIZE)
+    {
+        fprintf(stderr, "%s: not a HOL log index\n", path);
+        close(fd);
+        return -1;
+    }
+
+    const uint8_t* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) { perror("mmap"); return -1; }
+
+    if (memcmp(data, "HOLI", 4) != 0 || data[4] != LOG_FILE_INDEX_VERSION ||
+        data[8] != LOG_FILE_INDEX_ENTRY_SIZE)
+    {
+        fprintf(stderr, "%s: unsupported index header\n", path);
+        munmap((void*)data, (size_t)st.st_size);
+        return -1;
+    }
+
+    index->flags = (uint32_t)data[12] | ((uint32_t)data[13] << 8) |
+                   ((uint32_t)data[14] << 16) | ((uint32_t)data[15] << 24);
+    index->entries = data + LOG_FILE_INDEX_HEADER_SIZE;
+    index->count = ((size_t)st.st_size - LOG_FILE_INDEX_HEADER_SIZE) / LOG_FILE_INDEX_ENTRY_SIZE;
+    *mapped_size = (size_t)st.st_size;
+    return 0;
+}
+
+static void index_at(const index_t* index, size_t i, hol_log_index_entry_t* entry)
+{
+    hol_log_index_decode(index->entries + i * LOG_FILE_INDEX_ENTRY_SIZE, entry);
+}
+
+/* Number of entries with timestamp <= t (entries are in time order) */
+static size_t index_upper_bound(const index_t* index, uint64_t t)
+{
+    size_t lo = 0;
+    size_t hi = index->count;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        hol_log_index_entry_t e;
+        index_at(index, mid, &e);
+        if (e.timestamp_ms <= t) { lo = mid + 1; }
+        else                     { hi = mid; }
+    }
+    return lo;
+}
+
+/*
+ * Per-level lines between entries first and last. Counts are cumulative, but
+ * indexes written before counts were carried across reopen restart at zero
+ * there: a count that drops is taken as a new baseline, not a negative delta.
+ */
+static void index_count(const index_t* index, size_t first, size_t last,
+                        uint32_t counts[LOG_FILE_LEVELS])
+{
+    hol_log_index_entry_t prev = { 0 };
+    if (first > 0) { index_at(index, first - 1, &prev); }
+    memset(counts, 0, LOG_FILE_LEVELS * sizeof(counts[0]));
+    for (size_t i = first; i <= last && i < index->count; i++)
+    {
+        hol_log_index_entry_t e;
+        index_at(index, i, &e);
+        for (unsigned l = 0; l < LOG_FILE_LEVELS; l++)
+        {
+            counts[l] += (e.lines[l] >= prev.lines[l]) ? e.lines[l] - prev.lines[l] : e.lines[l];
+        }
+        prev = e;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool counts_only = false;
+    int arg = 1;
+    if (arg < argc && strcmp(argv[arg], "-c") == 0) { counts_only = true; arg++; }
+    if (argc - arg != 4)
+    {
+        fprintf(stderr, "usage: %s [-c] <log_file> <index_file> <from_ms> <to_ms>\n", argv[0]);
+        return 2;
+    }
+
+    const char* log_path = argv[arg];
+    const char* index_path = argv[arg + 1];
+    uint64_t from_ms = strtoull(argv[arg + 2], NULL, 10);
+    uint64_t to_ms = strtoull(argv[arg + 3], NULL, 10);
+
+    index_t index;
+    size_t index_size;
+    if (index_load(index_path, &index, &index_size) != 0) { return 1; }
+
+    int fd = open(log_path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) { perror(log_path); return 1; }
+    uint64_t file_size = (uint64_t)st.st_size;
+
+    /* Start: last entry at or before from_ms (file start if none) */
+    size_t first = index_upper_bound(&index, from_ms);
+    hol_log_index_entry_t start = { 0 };
+    if (first > 0) { index_at(&index, first - 1, &start); }
+
+    /* End: first entry after to_ms (end of file if none) */
+    size_t last = index_upper_bound(&index, to_ms);
+    hol_log_index_entry_t end = { 0 };
+    bool end_is_eof = (last >= index.count);
+    if (!end_is_eof) { index_at(&index, last, &end); }
+    else if (index.count > 0) { index_at(&index, index.count - 1, &end); }
+
+    uint64_t begin_off = (start.offset < file_size) ? start.offset : file_size;
+    uint64_t end_off = end_is_eof ? file_size : ((end.offset < file_size) ? end.offset : file_size);
+    if (end_off < begin_off) { end_off = begin_off; }
+
+    if (counts_only)
+    {
+        static const char* names[LOG_FILE_LEVELS] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+        printf("bytes %llu-%llu (%llu bytes)%s\n", (unsigned long long)begin_off,
+               (unsigned long long)end_off, (unsigned long long)(end_off - begin_off),
+               end_is_eof ? ", counts up to the last index entry" : "");
+        uint32_t counts[LOG_FILE_LEVELS];
+        index_count(&index, first, end_is_eof ? index.count - 1 : last, counts);
+        for (unsigned l = 0; l < LOG_FILE_LEVELS; l++)
+        {
+            printf("%-8s %u\n", names[l], counts[l]);
+        }
+    }
+    else if (end_off > begin_off)
+    {
+        /* Map only the window, starting on a page boundary */
+        uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t map_off = begin_off - (begin_off % page);
+        size_t map_len = (size_t)(end_off - map_off);
+        const char* map = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, (off_t)map_off);
+        if (map == MAP_FAILED) { perror("mmap"); return 1; }
+        (void)madvise((void*)map, map_len, MADV_SEQUENTIAL);
+
+        const char* p = map + (begin_off - map_off);
+        size_t len = (size_t)(end_off - begin_off);
+        if ((index.flags & LOG_FILE_INDEX_COMPRESSED) == 0)
+        {
+            if (fwrite(p, 1, len, stdout) != len) { perror("write"); return 1; }
+        }
+        else
+        {
+            static uint8_t raw[1u << 24];   /* Largest block we accept: 16 MB */
+            while (len > 0)
+            {
+                size_t used;
+                long n = hol_lz_frame_decode((const uint8_t*)p, len, raw, sizeof(raw), &used);
+                if (n < 0)
+                {
+                    fprintf(stderr, "corrupt block at offset %llu\n",
+                            (unsigned long long)(end_off - len));
+                    return 1;
+                }
+                if (fwrite(raw, 1, (size_t)n, stdout) != (size_t)n) { perror("write"); return 1; }
+                p += used;
+                len -= used;
+            }
+        }
+        munmap((void*)map, map_len);
+    }
+
+    munmap((void*)(index.entries - LOG_FILE_INDEX_HEADER_SIZE), index_size);
+    close(fd);
+    return 0;
+}
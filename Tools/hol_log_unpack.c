@@ -0,0 +1,68 @@
+/**
+ * @file hol_log_unpack.c
+ * @brief Decompress a whole HLZ1 block file written by the compressed file sink
+ *
+ * Build:
+ *   cc -O2 -I../Logger -o hol_log_unpack hol_log_unpack.c
+ *
+ * Usage:
+ *   hol_log_unpack <compressed_log> [output_text]      (default output: stdout)
+ *
+ * For time-bounded reads use hol_log_query with the sidecar index instead.
+ */
+
+#include "HOL_LogCompress.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: %s <compressed_log> [output_text]\n", argv[0]);
+        return 2;
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) { perror(argv[1]); return 1; }
+
+    FILE* out = (argc == 3) ? fopen(argv[2], "wb") : stdout;
+    if (out == NULL) { perror(argv[2]); return 1; }
+
+    static uint8_t raw[1u << 24];   /* Largest block we accept: 16 MB */
+    size_t size = (size_t)st.st_size;
+    int rc = 0;
+
+    if (size > 0)
+    {
+        const uint8_t* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) { perror("mmap"); return 1; }
+        (void)madvise((void*)data, size, MADV_SEQUENTIAL);
+
+        size_t pos = 0;
+        while (pos < size)
+        {
+            size_t used;
+            long n = hol_lz_frame_decode(&data[pos], size - pos, raw, sizeof(raw), &used);
+            if (n < 0)
+            {
+                fprintf(stderr, "corrupt block at offset %zu\n", pos);
+                rc = 1;
+                break;
+            }
+            if (fwrite(raw, 1, (size_t)n, out) != (size_t)n) { perror("write"); rc = 1; break; }
+            pos += used;
+        }
+        munmap((void*)data, size);
+    }
+
+    if (out != stdout) { fclose(out); }
+    close(fd);
+    return rc;
+}